@@ -0,0 +1,521 @@
+"""This script fuzzes the engines of the Core interpreter differentially.
+
+usage: fuzz.py [-h] [--runs N] [--seed N] [--statements N] [--depth N]
+               [--configs NAME [NAME ...]] [--max-steps N] [--max-bits N]
+               [--max-output N] [--timeout S] [--corpus DIR]
+               [--output DIR] [--keep-going]
+
+options:
+    -h, --help  show this help message, and exit
+
+    --runs N    the number of programs to generate (default: 100)
+
+    --seed N    the seed of the first program; the seeds of the others
+                follow it (default: 0)
+
+    --statements N
+                the largest number of statements of a program
+                (default: 40)
+
+    --depth N   the maximum nesting depth of a program (default: 3)
+
+    --configs NAME [NAME ...]
+                the configurations of CONFIGS to compare with the
+                tree-walk (default: every configuration)
+
+    --max-steps N
+                the step limit of every run, and the step budget of
+                --specialize (default: 5000)
+
+    --max-bits N
+                the integer size limit of every run (default: 4096)
+
+    --max-output N
+                the output limit of every run (default: 100000)
+
+    --timeout S
+                the number of seconds after which a run is killed and
+                its program skipped (default: 30)
+
+    --corpus DIR
+                the directory of the programs to check before the
+                generated ones (default: the corpus directory next to
+                this script)
+
+    --output DIR
+                the directory that reproducers are written to
+                (default: the current directory)
+
+    --keep-going
+                go on generating programs after a mismatch
+
+Every program is generated by the generate module as an unbounded
+program, with a random number of statements and loop iterations, so
+that it may end with any runtime error of Core or loop until the step
+limit ends it. The program is run by interpret.py with the tree-walk,
+which is the reference, and with every configuration in CONFIGS, each
+of which selects an engine, an optimization, an output format, or a
+data source. The reference is run with the output format and base of
+the configuration, and reads the data file as text. A configuration
+matches the reference if it exits with the same status, writes the same
+output, prints the same last line to stderr, which holds the message of
+any error, and lists the program the same way. A configuration whose
+data file is binary, converted by data_convert.py, or piped to stdin
+("-") may name it differently in its error messages.
+
+There are three exceptions. --detect-cycles may end a loop that the
+reference ends at the step limit with its own error. The format-only
+configuration does not execute the program, and only matches if it
+lays it out exactly as the listing that the reference prints after
+parsing it. The specialize configuration partially evaluates the
+program with --specialize; if it does not fold completely, its residual
+program is run by the tree-walk on the rest of the data file. Its
+output and exit status must match the reference, and its error message
+only up to the file and line, unless the reference ends at a resource
+limit, which the specializer does not enforce. A run killed by the
+timeout is inconclusive, and its program is skipped.
+
+The programs of the corpus directory, each a .core file with a data
+file of the same name ending in .txt, are checked before the generated
+programs. They are regression cases of the shapes of programs that
+mismatched before, such as reproducers moved there.
+
+Every configuration that mismatches on a program is reported. A
+mismatch is minimized by delta debugging: lines of the program, and
+then of the data file, are removed as long as the configuration still
+mismatches the reference, and the smallest program and data file are
+written to the output directory as mismatch-SEED-CONFIG.core and
+mismatch-SEED-CONFIG.txt, where SEED is the seed of the program or its
+name in the corpus. The script exits with status 1 if any mismatch was
+found.
+"""
+
+import argparse
+import os
+import random
+import re
+import subprocess
+import sys
+import tempfile
+from typing import Callable, Iterator
+
+import generate
+
+SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                      os.pardir, 'src')
+INTERPRETER = os.path.join(SOURCE, 'interpret.py')
+CONVERTER = os.path.join(SOURCE, 'data_convert.py')
+CORPUS = os.path.join(os.path.dirname(os.path.abspath(__file__)), 'corpus')
+
+CONFIGS = {
+    'trace': ['--engine', 'trace', '--jit-threshold', '2'],
+    'tiered': ['--engine', 'tiered', '--jit-threshold', '2'],
+    'int64': ['--engine', 'tiered', '--jit-threshold', '2', '--int64'],
+    'loop-cache': ['--loop-cache', '4'],
+    'tiered-loop-cache': ['--engine', 'tiered', '--jit-threshold', '2',
+                          '--loop-cache', '4'],
+    'detect-cycles': ['--detect-cycles'],
+    'prefetch': ['--prefetch'],
+    'specialize': ['--specialize'],
+    'tiered-jsonl': ['--engine', 'tiered', '--jit-threshold', '2',
+                     '--output-format', 'jsonl'],
+    'trace-hex': ['--engine', 'trace', '--jit-threshold', '2',
+                  '--output-base', '16'],
+    'int64-binary': ['--engine', 'tiered', '--jit-threshold', '2', '--int64',
+                     '--output-base', '2'],
+    'binary-data': [],
+    'prefetch-binary-data': ['--prefetch'],
+    'stdin': [],
+    'format-only': ['--format-only']
+}
+DATA = {
+    'binary-data': 'binary',
+    'prefetch-binary-data': 'binary',
+    'stdin': 'stdin'
+}
+SHARED = ('--output-format', '--output-base')
+LIMIT_STATUS = 3
+RESIDUAL = '\n----------Residual Program----------\n'
+
+Outcome = tuple[int, str, str, str]
+
+def shared(options: list[str]) -> list[str]:
+    """Return the options of a configuration that its reference shares."""
+    return [option for flag, value in zip(options, options[1:])
+            if flag in SHARED for option in (flag, value)]
+
+def locate(message: str) -> str:
+    """Return an error message without the file and line it names."""
+    return re.sub(r'File ".*", line \d+: ', '', message)
+
+class Fuzzer:
+    """The runs of the reference and the configurations on a program.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            run
+            specialize
+            reference
+            outcome
+            matches
+            mismatches
+
+        Private instance methods:
+            _execute
+
+        Private instance variables:
+            _limits: the options of interpret.py that bound every run.
+            _budget: the step budget of --specialize.
+            _timeout: the number of seconds after which a run is killed.
+            _directory: the directory of the files of the program.
+    """
+
+    def __init__(self, args: argparse.Namespace, directory: str) -> None:
+        self._limits = ['--max-steps', str(args.max_steps),
+                        '--max-bits', str(args.max_bits),
+                        '--max-output', str(args.max_output)]
+        self._budget = args.max_steps
+        self._timeout = args.timeout
+        self._directory = directory
+
+    def _execute(self, options: list[str], program: str, data: str,
+                 source: str = 'text'
+                 ) -> tuple[int, str, list[str], str] | None:
+        """Run a program, and keep every line that it prints to stderr.
+
+        The data file is named in stderr as the text data file,
+        whatever the source it was read from.
+
+        Returns:
+            The exit status, the output, the lines printed to stderr,
+            and the listing of the program, or None if the run was
+            killed by the timeout.
+        """
+        paths = (os.path.join(self._directory, 'program.core'),
+                 os.path.join(self._directory, 'data.txt'))
+        for path, text in zip(paths, (program, data)):
+            with open(path, 'w') as file:
+                file.write(text)
+        listing = os.path.join(self._directory, 'listing.core')
+        if os.path.exists(listing):
+            os.remove(listing)
+        name = paths[1]
+        if source == 'binary':
+            name = os.path.join(self._directory, 'data.bin')
+            subprocess.run([sys.executable, CONVERTER, paths[1], name,
+                            '--to', 'binary'], check = True)
+        if source == 'stdin':
+            name = '<stdin>'
+        try:
+            with open(paths[1], 'rb') as stdin:
+                process = subprocess.run(
+                    [sys.executable, INTERPRETER, '--listing-file', listing,
+                     *self._limits, *options, paths[0],
+                     '-' if source == 'stdin' else name],
+                    stdin = stdin if source == 'stdin' else None,
+                    capture_output = True, text = True,
+                    timeout = self._timeout)
+        except subprocess.TimeoutExpired:
+            return None
+        text = ''
+        if os.path.exists(listing):
+            with open(listing) as file:
+                text = file.read()
+        return (process.returncode, process.stdout,
+                process.stderr.replace(name, paths[1]).strip().split('\n'),
+                text)
+
+    def run(self, options: list[str], program: str, data: str,
+            source: str = 'text') -> Outcome | None:
+        """Run a program with the options of a configuration.
+
+        Args:
+            options: The options of interpret.py that select the
+                configuration.
+            program: The text of the Core program.
+            data: The text of its data file.
+            source: "text" to read the data file, "binary" to read it
+                converted to the binary format, or "stdin" to pipe it.
+
+        Returns:
+            The exit status, the output, the last line printed to
+            stderr, and the listing of the program, which is empty if
+            the program did not parse, or None if the run was killed by
+            the timeout.
+        """
+        result = self._execute(options, program, data, source)
+        if result is None:
+            return None
+        status, output, errors, listing = result
+        return status, output, errors[-1], listing
+
+    def specialize(self, program: str, data: str) -> Outcome | None:
+        """Specialize a program, and run its residual program if any.
+
+        The residual program is run by the tree-walk on the data file
+        from the line that the statistics of the specializer report.
+
+        Returns:
+            The outcome of the folded program or of its residual
+            program, with the listing of the program, or None if either
+            run was killed by the timeout.
+        """
+        result = self._execute(['--specialize', '--stats', '--budget',
+                                str(self._budget)], program, data)
+        if result is None:
+            return None
+        status, output, errors, listing = result
+        if errors[-1].startswith('  ') or errors[-1].startswith(
+                'Specializer statistics'):
+            errors.append('')
+        if RESIDUAL not in output:
+            return status, output, errors[-1], listing
+        start = 1
+        for error in errors:
+            found = re.search(r'reads the data file from line (\d+)', error)
+            if found:
+                start = int(found.group(1))
+        outcome = self.run([], output.split(RESIDUAL, 1)[1],
+                           ''.join(data.splitlines(True)[start - 1:]))
+        if outcome is None:
+            return None
+        return outcome[0], outcome[1], outcome[2], listing
+
+    def reference(self, name: str, program: str,
+                  data: str) -> Outcome | None:
+        """Run the tree-walk with the options a configuration shares."""
+        return self.run(shared(CONFIGS[name]), program, data)
+
+    def outcome(self, name: str, program: str,
+                data: str) -> Outcome | None:
+        """Run a program with a configuration."""
+        if name == 'specialize':
+            return self.specialize(program, data)
+        return self.run(CONFIGS[name], program, data,
+                        DATA.get(name, 'text'))
+
+    def matches(self, name: str, reference: Outcome,
+                outcome: Outcome) -> bool:
+        """Return whether the outcome of a configuration is equivalent.
+
+        Any layout of a program that does not parse matches, so that
+        minimizing a mismatch of format-only keeps the program valid.
+
+        Args:
+            name: The name of the configuration in CONFIGS.
+            reference: The outcome of the tree-walk.
+            outcome: The outcome of the configuration.
+        """
+        if name == 'format-only':
+            return not reference[3] or outcome[3] == reference[3]
+        if outcome == reference:
+            return True
+        if name == 'specialize':
+            return (reference[0] == LIMIT_STATUS
+                    or (outcome[:2] == reference[:2]
+                        and outcome[3] == reference[3]
+                        and locate(outcome[2]) == locate(reference[2])))
+        return (name == 'detect-cycles' and outcome[1] == reference[1]
+                and outcome[3] == reference[3]
+                and 'step limit of' in reference[2]
+                and outcome[2].endswith('infinite loop detected!'))
+
+    def mismatches(self, name: str, program: str, data: str) -> bool:
+        """Return whether a configuration mismatches on a program.
+
+        A run killed by the timeout does not mismatch.
+        """
+        reference = self.reference(name, program, data)
+        if reference is None:
+            return False
+        outcome = self.outcome(name, program, data)
+        return outcome is not None and not self.matches(name, reference,
+                                                        outcome)
+
+def minimize(lines: list[str], test: Callable[[list[str]], bool]
+             ) -> list[str]:
+    """Return a subsequence of lines that still passes a test.
+
+    Remove ever smaller chunks of the lines as long as the rest passes
+    the test, until no single line can be removed.
+
+    Args:
+        lines: Lines that pass the test.
+        test: The predicate of a subsequence of the lines.
+    """
+    chunks = 2
+    while len(lines) >= 2:
+        size = -(-len(lines) // chunks)
+        for start in range(0, len(lines), size):
+            rest = lines[:start] + lines[start + size:]
+            if test(rest):
+                lines = rest
+                chunks = max(chunks - 1, 2)
+                break
+        else:
+            if size == 1:
+                break
+            chunks = min(chunks * 2, len(lines))
+    return lines
+
+def reduce(fuzzer: Fuzzer, name: str, program: str,
+           data: str) -> tuple[str, str]:
+    """Minimize the program and data file of a mismatch.
+
+    Returns:
+        The text of the smallest program and data file found.
+    """
+    def join(lines: list[str]) -> str:
+        return ''.join(line + '\n' for line in lines)
+    code = minimize(program.splitlines(), lambda lines: fuzzer.mismatches(
+                        name, join(lines), data))
+    values = minimize(data.splitlines(), lambda lines: fuzzer.mismatches(
+                          name, join(code), join(lines)))
+    return join(code), join(values)
+
+def check(fuzzer: Fuzzer, args: argparse.Namespace, seed: str,
+          program: str, data: str) -> tuple[int, int]:
+    """Compare every configuration with the reference on a program.
+
+    Report and minimize every configuration that mismatches.
+
+    Args:
+        fuzzer: The runs of the program.
+        args: The parsed command line arguments.
+        seed: The seed of the program, or its name in the corpus.
+        program: The text of the Core program.
+        data: The text of its data file.
+
+    Returns:
+        The number of configurations that mismatched, and the number
+        of runs killed by the timeout.
+    """
+    found = skipped = 0
+    references = {}
+    for name in args.configs:
+        options = tuple(shared(CONFIGS[name]))
+        if options not in references:
+            references[options] = fuzzer.reference(name, program, data)
+        reference = references[options]
+        if reference is None:
+            skipped += 1
+            continue
+        outcome = fuzzer.outcome(name, program, data)
+        if outcome is None:
+            skipped += 1
+            continue
+        if fuzzer.matches(name, reference, outcome):
+            continue
+        found += 1
+        code, values = reduce(fuzzer, name, program, data)
+        stem = os.path.join(args.output,
+                            'mismatch-{0}-{1}'.format(seed, name))
+        with open(stem + '.core', 'w') as file:
+            file.write(code)
+        with open(stem + '.txt', 'w') as file:
+            file.write(values)
+        print('Seed {0}: {1} mismatches the tree-walk; reproducer '
+              'written to {2}.core'.format(seed, name, stem))
+        print('  tree-walk: exit status {0}, {1}'.format(
+                  reference[0], reference[2] or 'no error'))
+        print('  {0}: exit status {1}, {2}'.format(
+                  name, outcome[0], outcome[2] or 'no error'))
+    return found, skipped
+
+def programs(args: argparse.Namespace) -> Iterator[tuple[str, str, str]]:
+    """Yield the programs of the corpus, and then the generated ones.
+
+    Yields:
+        The seed of the program or its name in the corpus, the text of
+        the Core program, and the text of its data file.
+    """
+    for entry in sorted(os.listdir(args.corpus)):
+        stem, extension = os.path.splitext(entry)
+        if extension != '.core':
+            continue
+        with open(os.path.join(args.corpus, entry)) as file:
+            program = file.read()
+        with open(os.path.join(args.corpus, stem + '.txt')) as file:
+            yield stem, program, file.read()
+    for seed in range(args.seed, args.seed + args.runs):
+        shape = random.Random(seed)
+        program, values = generate.Generator(
+            statements = shape.randint(1, args.statements),
+            depth = args.depth, expression = shape.randint(1, 6),
+            identifiers = shape.randint(1, 8),
+            iterations = shape.randint(0, 20), seed = seed,
+            bounded = False).generate()
+        yield (str(seed), program,
+               ''.join('{0}\n'.format(value) for value in values))
+
+def main() -> None:
+    """Fuzz the configurations, and write a reproducer of every mismatch."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--runs', type = int, default = 100, metavar = 'N',
+                        help = 'the number of programs to generate '
+                               '(default: 100)')
+    parser.add_argument('--seed', type = int, default = 0, metavar = 'N',
+                        help = 'the seed of the first program; the seeds of '
+                               'the others follow it (default: 0)')
+    parser.add_argument('--statements', type = int, default = 40,
+                        metavar = 'N',
+                        help = 'the largest number of statements of a '
+                               'program (default: 40)')
+    parser.add_argument('--depth', type = int, default = 3, metavar = 'N',
+                        help = 'the maximum nesting depth of a program '
+                               '(default: 3)')
+    parser.add_argument('--configs', nargs = '+', metavar = 'NAME',
+                        choices = list(CONFIGS), default = list(CONFIGS),
+                        help = 'the configurations of CONFIGS to compare '
+                               'with the tree-walk (default: every '
+                               'configuration)')
+    parser.add_argument('--max-steps', type = int, default = 5000,
+                        metavar = 'N',
+                        help = 'the step limit of every run, and the step '
+                               'budget of --specialize (default: 5000)')
+    parser.add_argument('--max-bits', type = int, default = 4096,
+                        metavar = 'N',
+                        help = 'the integer size limit of every run '
+                               '(default: 4096)')
+    parser.add_argument('--max-output', type = int, default = 100000,
+                        metavar = 'N',
+                        help = 'the output limit of every run '
+                               '(default: 100000)')
+    parser.add_argument('--timeout', type = float, default = 30,
+                        metavar = 'S',
+                        help = 'the number of seconds after which a run is '
+                               'killed and its program skipped (default: 30)')
+    parser.add_argument('--corpus', default = CORPUS, metavar = 'DIR',
+                        help = 'the directory of the programs to check '
+                               'before the generated ones (default: the '
+                               'corpus directory next to this script)')
+    parser.add_argument('--output', default = '.', metavar = 'DIR',
+                        help = 'the directory that reproducers are written '
+                               'to (default: the current directory)')
+    parser.add_argument('--keep-going', action = 'store_true',
+                        help = 'go on generating programs after a mismatch')
+    args = parser.parse_args()
+    if (args.runs <= 0 or args.statements <= 0 or args.max_steps <= 0
+            or args.max_bits <= 0 or args.max_output <= 0
+            or args.timeout <= 0):
+        parser.error('--runs, --statements, --timeout, and the limits must '
+                     'be positive')
+    os.makedirs(args.output, exist_ok = True)
+    found = skipped = runs = 0
+    with tempfile.TemporaryDirectory() as directory:
+        fuzzer = Fuzzer(args, directory)
+        for seed, program, data in programs(args):
+            mismatched, killed = check(fuzzer, args, seed, program, data)
+            found += mismatched
+            skipped += killed
+            runs += 1
+            if found and not args.keep_going:
+                break
+    print('{0} programs run, {1} mismatches, {2} runs skipped after the '
+          'timeout'.format(runs, found, skipped))
+    if found:
+        sys.exit(1)
+
+if __name__ == '__main__':
+    main()
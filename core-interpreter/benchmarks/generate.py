@@ -0,0 +1,441 @@
+"""This script generates synthetic Core programs from the Core grammar.
+
+usage: generate.py [-h] [--statements N] [--depth N] [--expression N]
+                   [--identifiers N] [--per-line N] [--iterations N]
+                   [--whitespace {normal,compact,spaced,blank}]
+                   [--unbounded] [--seed N] program data
+
+positional arguments:
+    program     the path of the file to write the Core program to
+
+    data        the path of the file to write its data to
+
+options:
+    -h, --help  show this help message, and exit
+
+    --statements N
+                the number of statements of the program, counting the
+                statements nested in others (default: 100)
+
+    --depth N   the maximum nesting depth of "if" and "while"
+                statements (default: 2)
+
+    --expression N
+                the number of operands of every expression
+                (default: 3)
+
+    --identifiers N
+                the number of identifiers declared for assignments,
+                besides the counters of the loops (default: 8)
+
+    --per-line N
+                the number of statements, or parts of compound
+                statements, laid out on every line (default: 1)
+
+    --iterations N
+                the number of iterations of every loop (default: 2)
+
+    --whitespace {normal,compact,spaced,blank}
+                the white space between tokens: one space, none where
+                none is needed, runs of spaces and tabs, or one space
+                and runs of blank lines (default: normal)
+
+    --unbounded
+                also derive loops that are not counted, products of
+                identifiers, and "read" statements anywhere, leave
+                identifiers uninitialized, and cut the data file
+                short, so that the program may not terminate or may
+                end with a runtime error
+
+    --seed N    the seed of the random choices (default: 0)
+
+An instance of the Generator class derives a Core program from <prog>
+with a method for every production of the Core grammar, making the
+random choices of a generator seeded with the seed, so that a program is
+the same at every run. The program is laid out by the whitespace style
+after it is derived, so that the same program can be laid out in every
+style.
+
+Every program executes in bounded time and space: every "while"
+statement counts its iterations in a counter of its own, which no other
+statement assigns, and multiplies an operand only by integer literals,
+so that values grow by a few bits per assignment executed. Every
+identifier is read from the data file before the statements, by "read"
+statements of eight identifiers each that are not counted among them,
+and other "read" statements appear only at the top level, so that the
+data file holds exactly the values that they read.
+
+None of this holds of an unbounded program, which is meant for the
+differential fuzzing of the fuzz module: it explores the runtime errors
+of Core and the loops that only a step limit ends.
+"""
+
+import argparse
+import random
+
+WHITESPACE = ('normal', 'compact', 'spaced', 'blank')
+
+COMPARISONS = ('!=', '==', '<', '>', '<=', '>=')
+
+class Generator:
+    """A seeded derivation of Core programs of a given size and shape.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            generate
+
+        Private instance methods:
+            _decl_seq
+            _stmt_seq
+            _stmt
+            _assign
+            _if
+            _loop
+            _in
+            _out
+            _id_list
+            _cond
+            _comp
+            _exp
+            _fac
+            _factor
+            _op
+            _int
+            _layout
+            _space
+            _join
+
+        Private instance variables:
+            _statements: The number of statements of the program.
+            _depth: The maximum nesting depth.
+            _expression: The number of operands of every expression.
+            _names: The identifiers that statements assign and read.
+            _per_line: The number of chunks per line.
+            _iterations: The number of iterations of every loop.
+            _whitespace: One of WHITESPACE.
+            _bounded: Whether the program is bounded.
+            _random: The random number generator of the choices.
+            _counters: the number of counters of loops derived so far.
+            _data: the values read by the "read" statements derived so
+                far.
+    """
+
+    def __init__(self, statements: int = 100, depth: int = 2,
+                 expression: int = 3, identifiers: int = 8,
+                 per_line: int = 1, iterations: int = 2,
+                 whitespace: str = 'normal', seed: int = 0,
+                 bounded: bool = True) -> None:
+        self._statements = max(statements, 1)
+        self._depth = max(depth, 0)
+        self._expression = max(expression, 1)
+        self._names = ['V{0}'.format(index)
+                       for index in range(max(identifiers, 1))]
+        self._per_line = max(per_line, 1)
+        self._iterations = max(iterations, 0)
+        self._whitespace = whitespace
+        self._bounded = bounded
+        self._random = random.Random(seed)
+        self._counters = 0
+        self._data = []
+
+    def generate(self) -> tuple[str, list[int]]:
+        """Derive a program from <prog>, and lay it out.
+
+        Returns:
+            The text of the program and the integers of its data file.
+        """
+        names = self._names
+        if not self._bounded:
+            names = [name for name in names if self._random.random() < 0.97]
+        start = [(1, ['read'] + self._id_list(names[index:index + 8]))
+                 for index in range(0, len(names), 8)]
+        self._data = [self._random.randint(-99, 99) for _ in names]
+        body = start + self._stmt_seq(self._statements, 0, True)
+        if not self._bounded and self._random.random() < 0.2:
+            del self._data[self._random.randint(0, len(self._data)):]
+        counters = ['C{0}'.format(index) for index in range(self._counters)]
+        chunks = ([(0, ['program'])]
+                  + self._decl_seq(self._names + counters)
+                  + [(0, ['begin'])] + body + [(0, ['end'])])
+        return self._layout(chunks), self._data
+
+    def _decl_seq(self, names: list[str]) -> list[tuple[int, list[str]]]:
+        """Derive <decl seq>, declaring up to eight identifiers per <decl>."""
+        chunks = []
+        for start in range(0, len(names), 8):
+            tokens = ['int']
+            for name in names[start:start + 8]:
+                tokens += [name, ',']
+            chunks.append((1, tokens[:-1] + [';']))
+        return chunks
+
+    def _stmt_seq(self, budget: int, depth: int,
+                  top: bool) -> list[tuple[int, list[str]]]:
+        """Derive <stmt seq> with a number of statements.
+
+        Args:
+            budget: The number of statements to derive, at least 1.
+            depth: The nesting depth of the sequence.
+            top: Whether the sequence is the body of the program, the
+                only one where "read" statements are derived.
+
+        Returns:
+            The chunks of the sequence: tuples of an indentation level
+            and the tokens of a statement, or of the part of a compound
+            statement, at that level.
+        """
+        chunks = []
+        while budget > 0:
+            used, derived = self._stmt(budget, depth, top)
+            chunks += derived
+            budget -= used
+        return chunks
+
+    def _stmt(self, budget: int, depth: int, top: bool
+              ) -> tuple[int, list[tuple[int, list[str]]]]:
+        """Derive <stmt> within a budget of statements.
+
+        Returns:
+            The number of statements derived, and their chunks.
+        """
+        choice = self._random.random()
+        if depth < self._depth and budget >= 4 and choice < 0.15:
+            return self._loop(budget, depth)
+        if depth < self._depth and budget >= 2 and choice < 0.3:
+            return self._if(budget, depth)
+        if (top or not self._bounded) and choice < 0.35:
+            return 1, [self._in(depth)]
+        if choice < 0.45:
+            return 1, [self._out(depth)]
+        return 1, [self._assign(depth)]
+
+    def _assign(self, depth: int) -> tuple[int, list[str]]:
+        """Derive <assign> to one of the identifiers."""
+        return (depth + 1, [self._random.choice(self._names), '=']
+                + self._exp(self._expression) + [';'])
+
+    def _if(self, budget: int, depth: int
+            ) -> tuple[int, list[tuple[int, list[str]]]]:
+        """Derive <if>, with an "else" branch half of the time."""
+        body = self._random.randint(1, max((budget - 1) // 2, 1))
+        chunks = [(depth + 1, ['if'] + self._cond() + ['then'])]
+        chunks += self._stmt_seq(body, depth + 1, False)
+        used = body + 1
+        if budget - used >= 1 and self._random.random() < 0.5:
+            other = self._random.randint(1, max((budget - used) // 2, 1))
+            chunks += [(depth + 1, ['else'])]
+            chunks += self._stmt_seq(other, depth + 1, False)
+            used += other
+        return used, chunks + [(depth + 1, ['end', ';'])]
+
+    def _loop(self, budget: int, depth: int
+              ) -> tuple[int, list[tuple[int, list[str]]]]:
+        """Derive <loop> counted by a counter of its own.
+
+        The counter is set to 0 before the loop, compared with the
+        number of iterations in its condition, and incremented at the
+        end of its body, which makes three statements besides the body.
+        Half of the loops of an unbounded program are not counted.
+        """
+        if not self._bounded and self._random.random() < 0.5:
+            body = self._random.randint(1, max((budget - 1) // 2, 1))
+            chunks = [(depth + 1, ['while'] + self._cond() + ['loop'])]
+            chunks += self._stmt_seq(body, depth + 1, False)
+            return body + 1, chunks + [(depth + 1, ['end', ';'])]
+        counter = 'C{0}'.format(self._counters)
+        self._counters += 1
+        body = self._random.randint(1, max((budget - 3) // 2, 1))
+        bound = ['(', counter, '<', str(self._iterations), ')']
+        if self._random.random() < 0.5:
+            bound = ['[', *bound, '&&', *self._cond(), ']']
+        chunks = [(depth + 1, [counter, '=', '0', ';']),
+                  (depth + 1, ['while'] + bound + ['loop'])]
+        chunks += self._stmt_seq(body, depth + 1, False)
+        chunks += [(depth + 2, [counter, '=', counter, '+', '1', ';']),
+                   (depth + 1, ['end', ';'])]
+        return body + 3, chunks
+
+    def _in(self, depth: int) -> tuple[int, list[str]]:
+        """Derive <in>, and draw the values that it reads."""
+        names = self._random.sample(self._names,
+                                    self._random.randint(1, min(
+                                        len(self._names), 3)))
+        self._data += [self._random.randint(-99, 99) for _ in names]
+        return depth + 1, ['read'] + self._id_list(names)
+
+    def _out(self, depth: int) -> tuple[int, list[str]]:
+        """Derive <out>."""
+        names = self._random.sample(self._names,
+                                    self._random.randint(1, min(
+                                        len(self._names), 3)))
+        return depth + 1, ['write'] + self._id_list(names)
+
+    def _id_list(self, names: list[str]) -> list[str]:
+        """Derive <id list> followed by the ";" of its statement."""
+        tokens = []
+        for name in names:
+            tokens += [name, ',']
+        return tokens[:-1] + [';']
+
+    def _cond(self, comps: int | None = None) -> list[str]:
+        """Derive <cond> from a number of <comp> nonterminals.
+
+        Args:
+            comps: The number of <comp> nonterminals, or None to draw
+                it from the number of operands of an expression.
+        """
+        if comps is None:
+            comps = self._random.randint(1, max(self._expression // 2, 1))
+        if comps == 1:
+            if self._random.random() < 0.2:
+                return ['!'] + self._cond(1)
+            return self._comp()
+        left = self._random.randint(1, comps - 1)
+        return (['['] + self._cond(left)
+                + [self._random.choice(('&&', '||'))]
+                + self._cond(comps - left) + [']'])
+
+    def _comp(self) -> list[str]:
+        """Derive <comp>."""
+        return (['('] + self._op() + [self._random.choice(COMPARISONS)]
+                + self._op() + [')'])
+
+    def _exp(self, operands: int) -> list[str]:
+        """Derive <exp> with a number of operands, at least 1."""
+        size = self._random.randint(1, min(operands, 3))
+        tokens = self._fac(size)
+        if operands > size:
+            tokens += [self._random.choice('+-')] + self._exp(operands - size)
+        return tokens
+
+    def _fac(self, operands: int) -> list[str]:
+        """Derive <fac>, whose operands after the first are integers.
+
+        The first operand is a parenthesized <exp> of the other operands
+        but one a third of the time. The other operands of an unbounded
+        program are <op> nonterminals.
+        """
+        if operands > 1 and self._random.random() < 0.3:
+            return (['('] + self._exp(operands - 1) + [')', '*']
+                    + self._factor())
+        tokens = self._op()
+        for _ in range(operands - 1):
+            tokens += ['*'] + self._factor()
+        return tokens
+
+    def _factor(self) -> list[str]:
+        """Derive an <op> that multiplies the first operand of a <fac>."""
+        return [self._int(9)] if self._bounded else self._op()
+
+    def _op(self) -> list[str]:
+        """Derive <op> as an <int> or <id>."""
+        if self._random.random() < 0.3:
+            return [self._int(999)]
+        return [self._random.choice(self._names)]
+
+    def _int(self, high: int) -> str:
+        """Derive <int> between 0 and high."""
+        return str(self._random.randint(0, high))
+
+    def _layout(self, chunks: list[tuple[int, list[str]]]) -> str:
+        """Lay chunks out in lines of the whitespace style.
+
+        Every line holds the number of chunks per line, and is indented
+        by the level of its first chunk in the normal and blank styles.
+        """
+        lines = []
+        for start in range(0, len(chunks), self._per_line):
+            group = chunks[start:start + self._per_line]
+            tokens = [token for _, tokens in group for token in tokens]
+            indent = ''
+            if self._whitespace in ('normal', 'blank'):
+                indent = '  ' * group[0][0]
+            elif self._whitespace == 'spaced':
+                indent = self._space()
+            lines.append(indent + self._join(tokens))
+            if self._whitespace == 'blank':
+                lines += [self._random.choice(('', ' ', '\t'))
+                          for _ in range(self._random.randint(0, 3))]
+        return '\n'.join(lines) + '\n'
+
+    def _space(self) -> str:
+        """Return a run of spaces and tabs."""
+        return ''.join(self._random.choice(' \t')
+                       for _ in range(self._random.randint(1, 4)))
+
+    def _join(self, tokens: list[str]) -> str:
+        """Join the tokens of a line with the white space of the style."""
+        if self._whitespace == 'spaced':
+            return self._space().join(tokens)
+        text = tokens[0]
+        for token in tokens[1:]:
+            if self._whitespace == 'compact':
+                if (text[-1].isalnum() and token[0].isalnum()):
+                    text += ' '
+            elif token not in (';', ','):
+                text += ' '
+            text += token
+        return text
+
+def main() -> None:
+    """Write a program generated from the command line to files."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument('program',
+                        help = 'the path of the file to write the Core '
+                               'program to')
+    parser.add_argument('data',
+                        help = 'the path of the file to write its data to')
+    parser.add_argument('--statements', type = int, default = 100,
+                        metavar = 'N',
+                        help = 'the number of statements of the program, '
+                               'counting the statements nested in others '
+                               '(default: 100)')
+    parser.add_argument('--depth', type = int, default = 2, metavar = 'N',
+                        help = 'the maximum nesting depth of "if" and '
+                               '"while" statements (default: 2)')
+    parser.add_argument('--expression', type = int, default = 3,
+                        metavar = 'N',
+                        help = 'the number of operands of every expression '
+                               '(default: 3)')
+    parser.add_argument('--identifiers', type = int, default = 8,
+                        metavar = 'N',
+                        help = 'the number of identifiers declared for '
+                               'assignments, besides the counters of the '
+                               'loops (default: 8)')
+    parser.add_argument('--per-line', type = int, default = 1,
+                        metavar = 'N',
+                        help = 'the number of statements, or parts of '
+                               'compound statements, laid out on every line '
+                               '(default: 1)')
+    parser.add_argument('--iterations', type = int, default = 2,
+                        metavar = 'N',
+                        help = 'the number of iterations of every loop '
+                               '(default: 2)')
+    parser.add_argument('--whitespace', choices = list(WHITESPACE),
+                        default = 'normal',
+                        help = 'the white space between tokens: one space, '
+                               'none where none is needed, runs of spaces '
+                               'and tabs, or one space and runs of blank '
+                               'lines (default: normal)')
+    parser.add_argument('--unbounded', action = 'store_true',
+                        help = 'also derive loops that are not counted, '
+                               'products of identifiers, and "read" '
+                               'statements anywhere, leave identifiers '
+                               'uninitialized, and cut the data file short, '
+                               'so that the program may not terminate or may '
+                               'end with a runtime error')
+    parser.add_argument('--seed', type = int, default = 0, metavar = 'N',
+                        help = 'the seed of the random choices (default: 0)')
+    args = parser.parse_args()
+    program, data = Generator(args.statements, args.depth, args.expression,
+                              args.identifiers, args.per_line,
+                              args.iterations, args.whitespace, args.seed,
+                              not args.unbounded).generate()
+    with open(args.program, 'w') as file:
+        file.write(program)
+    with open(args.data, 'w') as file:
+        file.write(''.join('{0}\n'.format(value) for value in data))
+
+if __name__ == '__main__':
+    main()
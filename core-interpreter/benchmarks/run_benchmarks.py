@@ -0,0 +1,292 @@
+"""This script benchmarks the engines of the Core interpreter.
+
+usage: run_benchmarks.py [-h] [--workloads NAME [NAME ...]]
+                         [--engines ENGINE [ENGINE ...]] [--scale N]
+                         [--warmups N] [--repeats N] [--output PATH]
+                         [--compare PATH] [--pyperf]
+
+options:
+    -h, --help  show this help message, and exit
+
+    --workloads NAME [NAME ...]
+                the workloads of the workloads module to run (default:
+                every workload)
+
+    --engines ENGINE [ENGINE ...]
+                the engines of interpret.py to run every workload with
+                (default: tree trace tiered)
+
+    --scale N   the scale of the workloads (default: 1)
+
+    --warmups N
+                the number of runs of every workload and engine whose
+                times are discarded (default: 1)
+
+    --repeats N
+                the number of runs of every workload and engine whose
+                times are kept (default: 5)
+
+    --output PATH
+                write the results to PATH as a JSON object
+
+    --compare PATH
+                print the ratio of every median time to that of the
+                results written to PATH by an earlier run
+
+    --pyperf    run the benchmarks under pyperf instead, which spawns
+                worker processes, calibrates their loops, and takes the
+                pyperf options such as -o and --rigorous; every phase of
+                every workload and engine is a benchmark of its own
+
+Every run executes interpret.py in a fresh process with --metrics, the
+listing disabled, and the values written discarded, and reads the wall-
+clock time of the tokenize, parse, and execute phases from the metrics,
+along with the number of statements executed, which is the same in
+every run and every engine of a workload, so that it measures the work
+regardless of the time. A run that fails, such as one that exceeds the
+recursion limit of the parser, is recorded with its error instead.
+"""
+
+import argparse
+import datetime
+import json
+import os
+import platform
+import statistics
+import subprocess
+import sys
+import tempfile
+
+import workloads
+
+try:
+    import pyperf
+except ImportError:
+    pyperf = None
+
+INTERPRETER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                           os.pardir, 'src', 'interpret.py')
+
+ENGINES = ('tree', 'trace', 'tiered')
+
+PHASES = ('tokenize', 'parse', 'execute')
+
+def add_arguments(parser: argparse.ArgumentParser) -> None:
+    """Add the options of this script to a parser."""
+    parser.add_argument('--workloads', nargs = '+', metavar = 'NAME',
+                        choices = list(workloads.WORKLOADS),
+                        default = list(workloads.WORKLOADS),
+                        help = 'the workloads of the workloads module to run '
+                               '(default: every workload)')
+    parser.add_argument('--engines', nargs = '+', metavar = 'ENGINE',
+                        choices = list(ENGINES), default = list(ENGINES),
+                        help = 'the engines of interpret.py to run every '
+                               'workload with (default: tree trace tiered)')
+    parser.add_argument('--scale', type = int, default = 1, metavar = 'N',
+                        help = 'the scale of the workloads (default: 1)')
+    parser.add_argument('--pyperf', action = 'store_true',
+                        help = 'run the benchmarks under pyperf instead, '
+                               'which spawns worker processes, calibrates '
+                               'their loops, and takes the pyperf options '
+                               'such as -o and --rigorous; every phase of '
+                               'every workload and engine is a benchmark of '
+                               'its own')
+
+def prepare(names: list[str], scale: int, directory: str
+            ) -> dict[str, tuple[str, str]]:
+    """Write the programs and data of workloads to a directory.
+
+    Returns:
+        A dict whose keys are the names of the workloads and whose
+        values are the paths of their programs and data files.
+    """
+    paths = {}
+    for name in names:
+        paths[name] = (os.path.join(directory, name + '.core'),
+                       os.path.join(directory, name + '.txt'))
+        workloads.write(name, scale, *paths[name])
+    return paths
+
+def run(engine: str, program: str, data: str,
+        listing: bool = False) -> dict:
+    """Run a program once with an engine, and return its metrics.
+
+    Args:
+        engine: The engine of interpret.py.
+        program: The path of the Core program.
+        data: The path of its data file.
+        listing: Whether to print the program, to the null device, so
+            that the print phase is timed.
+
+    Returns:
+        The metrics written by interpret.py, as a dict in their JSON
+        layout.
+
+    Raises:
+        RuntimeError: interpret.py failed. The message is the last line
+            that it printed to stderr.
+    """
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join(directory, 'metrics.json')
+        process = subprocess.run(
+            [sys.executable, INTERPRETER, '--engine', engine,
+             *(['--listing-file', os.devnull] if listing
+               else ['--no-listing']),
+             '--output-format', 'null', '--metrics', path, program, data],
+            stdout = subprocess.DEVNULL, stderr = subprocess.PIPE, text = True)
+        if process.returncode:
+            lines = process.stderr.strip().split('\n')
+            raise RuntimeError(lines[-1] or 'exit status {0}'.format(
+                process.returncode))
+        with open(path) as file:
+            return json.load(file)
+
+def measure(engine: str, program: str, data: str, warmups: int,
+            repeats: int) -> dict:
+    """Run a program repeatedly with an engine, and summarize the times.
+
+    Returns:
+        A dict of the median and standard deviation of the wall-clock
+        time of every phase in seconds, its samples, and the numbers of
+        statements executed and tokens, or of the error of a failed run.
+    """
+    try:
+        for _ in range(warmups):
+            run(engine, program, data)
+        reports = [run(engine, program, data) for _ in range(repeats)]
+    except RuntimeError as error:
+        return {'error': str(error)}
+    result = {}
+    for name in PHASES:
+        samples = [report['phases'].get(name, {}).get('wall_seconds', 0.0)
+                   for report in reports]
+        result[name] = {'median': statistics.median(samples),
+                        'stdev': (statistics.stdev(samples)
+                                  if len(samples) > 1 else 0.0),
+                        'samples': samples}
+    counts = {report['statements_executed'] for report in reports}
+    if len(counts) > 1:
+        return {'error': 'statements executed differ between runs: '
+                         '{0}'.format(sorted(counts))}
+    result['statements'] = counts.pop()
+    result['tokens'] = reports[0]['tokens']
+    return result
+
+def report(results: dict, baseline: dict | None = None) -> None:
+    """Print the median times of the results, and their ratios if given.
+
+    Args:
+        results: The results of every workload and engine, in the
+            layout of the "results" member of the JSON output.
+        baseline: The results of an earlier run in the same layout, or
+            None.
+    """
+    width = 22 if baseline else 12
+    print('{0:<10}  {1:<7}  {2:>{6}}  {3:>{6}}  {4:>{6}}  {5:>12}'.format(
+              'Workload', 'Engine', 'Tokenize ms', 'Parse ms', 'Execute ms',
+              'Statements', width))
+    for name, engines in results.items():
+        for engine, result in engines.items():
+            if 'error' in result:
+                print('{0:<10}  {1:<7}  error: {2}'.format(
+                          name, engine, result['error']))
+                continue
+            cells = ['{0:>12.3f}'.format(1000 * result[phase]['median'])
+                     for phase in PHASES]
+            old = (baseline or {}).get(name, {}).get(engine, {})
+            if old and 'error' not in old:
+                cells = [cell + ' ({0:>6.2f}x)'.format(
+                             result[phase]['median'] / old[phase]['median']
+                             if old[phase]['median'] else float('nan'))
+                         for cell, phase in zip(cells, PHASES)]
+            cells = [cell.ljust(width) for cell in cells]
+            print('{0:<10}  {1:<7}  {2}  {3:>12}'.format(
+                      name, engine, '  '.join(cells), result['statements']))
+
+def time_phase(loops: int, engine: str, paths: tuple[str, str],
+               phase: str) -> float:
+    """Return the total wall-clock time of a phase over several runs.
+
+    Args:
+        loops: The number of runs, as chosen by pyperf.
+        engine: The engine of interpret.py.
+        paths: The paths of the Core program and its data file.
+        phase: One of PHASES.
+    """
+    return sum(run(engine, *paths)['phases'][phase]['wall_seconds']
+               for _ in range(loops))
+
+def run_pyperf() -> None:
+    """Register every phase of every workload and engine with pyperf."""
+    def forward(command: list[str], args: argparse.Namespace) -> None:
+        command += ['--pyperf', '--scale', str(args.scale),
+                    '--workloads', *args.workloads,
+                    '--engines', *args.engines]
+    runner = pyperf.Runner(add_cmdline_args = forward)
+    add_arguments(runner.argparser)
+    args = runner.parse_args()
+    with tempfile.TemporaryDirectory() as directory:
+        paths = prepare(args.workloads, args.scale, directory)
+        for name in args.workloads:
+            for engine in args.engines:
+                for phase in PHASES:
+                    runner.bench_time_func(
+                        '{0}-{1}-{2}'.format(name, engine, phase),
+                        time_phase, engine, paths[name], phase,
+                        metadata = {'scale': args.scale})
+
+def main() -> None:
+    """Run the benchmarks, print their times, and write them if asked."""
+    parser = argparse.ArgumentParser()
+    add_arguments(parser)
+    parser.add_argument('--warmups', type = int, default = 1, metavar = 'N',
+                        help = 'the number of runs of every workload and '
+                               'engine whose times are discarded '
+                               '(default: 1)')
+    parser.add_argument('--repeats', type = int, default = 5, metavar = 'N',
+                        help = 'the number of runs of every workload and '
+                               'engine whose times are kept (default: 5)')
+    parser.add_argument('--output', metavar = 'PATH',
+                        help = 'write the results to PATH as a JSON object')
+    parser.add_argument('--compare', metavar = 'PATH',
+                        help = 'print the ratio of every median time to that '
+                               'of the results written to PATH by an earlier '
+                               'run')
+    args, _ = parser.parse_known_args()
+    if args.pyperf:
+        if not pyperf:
+            parser.error('--pyperf requires the pyperf package')
+        run_pyperf()
+        return
+    args = parser.parse_args()
+    if args.scale <= 0:
+        parser.error('--scale must be positive')
+    if args.warmups < 0 or args.repeats <= 0:
+        parser.error('--warmups must not be negative, and --repeats must be '
+                     'positive')
+    baseline = None
+    if args.compare:
+        with open(args.compare) as file:
+            baseline = json.load(file)['results']
+    results = {}
+    with tempfile.TemporaryDirectory() as directory:
+        paths = prepare(args.workloads, args.scale, directory)
+        for name in args.workloads:
+            results[name] = {engine: measure(engine, *paths[name],
+                                             args.warmups, args.repeats)
+                             for engine in args.engines}
+    report(results, baseline)
+    if args.output:
+        with open(args.output, 'w') as file:
+            json.dump({'timestamp': datetime.datetime.now(
+                           datetime.timezone.utc).isoformat(),
+                       'python': platform.python_version(),
+                       'platform': platform.platform(),
+                       'scale': args.scale,
+                       'warmups': args.warmups,
+                       'repeats': args.repeats,
+                       'results': results}, file, indent = 2)
+            file.write('\n')
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,177 @@
+"""This script charts the throughput of the Core interpreter by input size.
+
+usage: scaling.py [-h] [--dimension
+                  {statements,depth,expression,identifiers,per-line}]
+                  [--start N] [--stop N] [--factor N]
+                  [--whitespace {normal,compact,spaced,blank}]
+                  [--engine {tree,trace,tiered}] [--repeats N] [--seed N]
+                  [--csv PATH]
+
+options:
+    -h, --help  show this help message, and exit
+
+    --dimension {statements,depth,expression,identifiers,per-line}
+                the option of generate.py that is swept (default:
+                statements)
+
+    --start N   the first value of the dimension (default: 100)
+
+    --stop N    the last value of the dimension, if it is reached
+                (default: 3200)
+
+    --factor N  the factor between two values of the dimension
+                (default: 2)
+
+    --whitespace {normal,compact,spaced,blank}
+                the white space of the programs (default: normal)
+
+    --engine {tree,trace,tiered}
+                the engine of interpret.py (default: tree)
+
+    --repeats N
+                the number of runs of every program, of which the
+                fastest is kept (default: 3)
+
+    --seed N    the seed of the programs (default: 0)
+
+    --csv PATH  write the sizes and throughputs to PATH as CSV
+
+For every value of the dimension, a program is generated by the generate
+module with that value and the defaults of the other options, and run by
+interpret.py with the listing printed to the null device, so that every
+phase is timed. The throughput of the tokenize, parse, and print phases
+is the number of tokens of the program per second, and that of the
+execute phase the number of statements executed per second, so that a
+phase that scales linearly has the same throughput at every size, and a
+scaling cliff shows as a drop. Every phase is charted with a bar per
+size whose length is its throughput relative to the highest.
+"""
+
+import argparse
+import csv
+import os
+import tempfile
+
+import generate
+import run_benchmarks
+
+DIMENSIONS = ('statements', 'depth', 'expression', 'identifiers', 'per-line')
+
+PHASES = ('tokenize', 'parse', 'print', 'execute')
+
+WIDTH = 50
+
+def sweep(args: argparse.Namespace) -> list[dict]:
+    """Generate and run a program for every value of the dimension.
+
+    Returns:
+        A dict for every value, of the value, the bytes and tokens of
+        the program, the statements executed, and the throughput of
+        every phase, or of the value and the error of a failed run.
+    """
+    rows = []
+    size = args.start
+    with tempfile.TemporaryDirectory() as directory:
+        program = os.path.join(directory, 'program.core')
+        data = os.path.join(directory, 'data.txt')
+        while size <= args.stop:
+            options = {'whitespace': args.whitespace, 'seed': args.seed,
+                       args.dimension.replace('-', '_'): size}
+            text, values = generate.Generator(**options).generate()
+            with open(program, 'w') as file:
+                file.write(text)
+            with open(data, 'w') as file:
+                file.write(''.join('{0}\n'.format(value)
+                                   for value in values))
+            try:
+                reports = [run_benchmarks.run(args.engine, program, data,
+                                              listing = True)
+                           for _ in range(args.repeats)]
+            except RuntimeError as error:
+                rows.append({'size': size, 'error': str(error)})
+                size *= args.factor
+                continue
+            row = {'size': size, 'bytes': len(text.encode()),
+                   'tokens': reports[0]['tokens'],
+                   'statements': reports[0]['statements_executed']}
+            for phase in PHASES:
+                seconds = min(report['phases'].get(phase, {})
+                              .get('wall_seconds', 0.0) for report in reports)
+                units = row['statements' if phase == 'execute' else 'tokens']
+                row[phase] = units / seconds if seconds > 0 else 0.0
+            rows.append(row)
+            size *= args.factor
+    return rows
+
+def chart(rows: list[dict], dimension: str) -> None:
+    """Print the throughputs of the rows as a table and a bar chart."""
+    print('{0:>10}  {1:>10}  {2:>10}  {3:>10}  {4}'.format(
+              dimension, 'Bytes', 'Tokens', 'Statements',
+              '  '.join('{0:>12}'.format(phase + '/s') for phase in PHASES)))
+    for row in rows:
+        if 'error' in row:
+            print('{0:>10}  error: {1}'.format(row['size'], row['error']))
+            continue
+        print('{0:>10}  {1:>10}  {2:>10}  {3:>10}  {4}'.format(
+                  row['size'], row['bytes'], row['tokens'], row['statements'],
+                  '  '.join('{0:>12.0f}'.format(row[phase])
+                            for phase in PHASES)))
+    measured = [row for row in rows if 'error' not in row]
+    for phase in PHASES:
+        highest = max((row[phase] for row in measured), default = 0.0)
+        unit = 'statements' if phase == 'execute' else 'tokens'
+        print('\n{0} ({1} per second)'.format(phase, unit))
+        for row in rows:
+            if 'error' in row:
+                print('{0:>10} | error'.format(row['size']))
+                continue
+            length = round(WIDTH * row[phase] / highest) if highest else 0
+            print('{0:>10} | {1:<{2}} {3:.0f}'.format(
+                      row['size'], '#' * length, WIDTH, row[phase]))
+
+def main() -> None:
+    """Sweep the dimension, chart the throughputs, and write them if asked."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--dimension', choices = list(DIMENSIONS),
+                        default = 'statements',
+                        help = 'the option of generate.py that is swept '
+                               '(default: statements)')
+    parser.add_argument('--start', type = int, default = 100, metavar = 'N',
+                        help = 'the first value of the dimension '
+                               '(default: 100)')
+    parser.add_argument('--stop', type = int, default = 3200, metavar = 'N',
+                        help = 'the last value of the dimension, if it is '
+                               'reached (default: 3200)')
+    parser.add_argument('--factor', type = int, default = 2, metavar = 'N',
+                        help = 'the factor between two values of the '
+                               'dimension (default: 2)')
+    parser.add_argument('--whitespace', choices = list(generate.WHITESPACE),
+                        default = 'normal',
+                        help = 'the white space of the programs '
+                               '(default: normal)')
+    parser.add_argument('--engine', choices = list(run_benchmarks.ENGINES),
+                        default = 'tree',
+                        help = 'the engine of interpret.py (default: tree)')
+    parser.add_argument('--repeats', type = int, default = 3, metavar = 'N',
+                        help = 'the number of runs of every program, of '
+                               'which the fastest is kept (default: 3)')
+    parser.add_argument('--seed', type = int, default = 0, metavar = 'N',
+                        help = 'the seed of the programs (default: 0)')
+    parser.add_argument('--csv', metavar = 'PATH',
+                        help = 'write the sizes and throughputs to PATH as '
+                               'CSV')
+    args = parser.parse_args()
+    if args.start <= 0 or args.factor < 2 or args.repeats <= 0:
+        parser.error('--start and --repeats must be positive, and --factor '
+                     'must be at least 2')
+    rows = sweep(args)
+    chart(rows, args.dimension)
+    if args.csv:
+        with open(args.csv, 'w', newline = '') as file:
+            writer = csv.DictWriter(file, ['size', 'bytes', 'tokens',
+                                           'statements', *PHASES, 'error'])
+            writer.writeheader()
+            writer.writerows(rows)
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,197 @@
+"""This script generates the benchmark workloads of the Core interpreter.
+
+usage: workloads.py [-h] [--scale N]
+                    {sum,gcd,fib,nested,wide,straight,synthetic}
+                    program data
+
+positional arguments:
+    {sum,gcd,fib,nested,wide,straight,synthetic}
+                the workload to generate
+
+    program     the path of the file to write the Core program to
+
+    data        the path of the file to write its data to
+
+options:
+    -h, --help  show this help message, and exit
+
+    --scale N   the factor that the size of the workload is multiplied
+                by (default: 1)
+
+Every workload is a function of a scale that returns the text of a Core
+program and the integers of its data file, and is registered in
+WORKLOADS. The size of a workload grows linearly with its scale: the
+iterations executed by the loop workloads, the declarations or
+statements parsed by the wide and straight workloads, and the statements
+generated by the synthetic workload with the generate module. The data
+are drawn from a random number generator seeded with the scale, so a
+workload is the same at every run.
+
+The parser recurses over the declarations and statements of a sequence,
+so the wide and straight workloads exceed the recursion limit of Python
+at a scale of a few units.
+"""
+
+import argparse
+import random
+from typing import Callable
+
+import generate
+
+def sum_workload(scale: int) -> tuple[str, list[int]]:
+    """Sum the integers from 1 to N in a single loop."""
+    program = '''program
+int N, S, I;
+begin
+read N;
+S = 0; I = 1;
+while (I <= N) loop
+  S = S + I;
+  I = I + 1;
+end;
+write S;
+end
+'''
+    return program, [50000 * scale]
+
+def gcd_workload(scale: int) -> tuple[str, list[int]]:
+    """Compute the GCD of pairs of integers by repeated subtraction."""
+    program = '''program
+int K, A, B;
+begin
+read K;
+while (K > 0) loop
+  read A, B;
+  while (A != B) loop
+    if (A > B) then
+      A = A - B;
+    else
+      B = B - A;
+    end;
+  end;
+  write A;
+  K = K - 1;
+end;
+end
+'''
+    generator = random.Random(scale)
+    pairs = 500 * scale
+    data = [pairs]
+    for _ in range(pairs):
+        data += [generator.randint(1, 2000), generator.randint(1, 2000)]
+    return program, data
+
+def fib_workload(scale: int) -> tuple[str, list[int]]:
+    """Compute the Nth Fibonacci number, which outgrows 64 bits."""
+    program = '''program
+int N, A, B, T, I;
+begin
+read N;
+A = 0; B = 1; I = 0;
+while (I < N) loop
+  T = A + B;
+  A = B;
+  B = T;
+  I = I + 1;
+end;
+write A;
+end
+'''
+    return program, [20000 * scale]
+
+def nested_workload(scale: int) -> tuple[str, list[int]]:
+    """Sum the products of the indices of two nested loops."""
+    program = '''program
+int N, M, C, I, J;
+begin
+read N, M;
+C = 0; I = 0;
+while (I < N) loop
+  J = 0;
+  while (J < M) loop
+    C = C + I * J;
+    J = J + 1;
+  end;
+  I = I + 1;
+end;
+write C;
+end
+'''
+    return program, [300 * scale, 100]
+
+def wide_workload(scale: int) -> tuple[str, list[int]]:
+    """Declare many identifiers, and assign each from the previous one."""
+    names = ['X{0}'.format(index) for index in range(200 * scale)]
+    lines = ['program']
+    lines += ['int {0};'.format(', '.join(names[start:start + 10]))
+              for start in range(0, len(names), 10)]
+    lines += ['begin', 'read {0};'.format(names[0])]
+    lines += ['{0} = {1} + 1;'.format(name, previous)
+              for previous, name in zip(names, names[1:])]
+    lines += ['write {0};'.format(names[-1]), 'end']
+    return '\n'.join(lines) + '\n', [0]
+
+def straight_workload(scale: int) -> tuple[str, list[int]]:
+    """Execute a long sequence of assignments without any loop."""
+    lines = ['program', 'int A, B, C, D;', 'begin', 'read A, B;',
+             'C = 0; D = 1;']
+    generator = random.Random(scale)
+    for _ in range(250 * scale):
+        target, left, right = generator.sample('ABCD', 3)
+        lines += ['{0} = {1} - {2} * 2 + {3};'.format(
+                      target, left, right, generator.randint(0, 99))]
+    lines += ['write A, B, C, D;', 'end']
+    return '\n'.join(lines) + '\n', [3, 5]
+
+def synthetic_workload(scale: int) -> tuple[str, list[int]]:
+    """Execute a program of nested statements from the generate module."""
+    return generate.Generator(statements = 300 * scale, depth = 3,
+                              expression = 5, identifiers = 16,
+                              seed = scale).generate()
+
+WORKLOADS: dict[str, Callable[[int], tuple[str, list[int]]]] = {
+    'sum': sum_workload,
+    'gcd': gcd_workload,
+    'fib': fib_workload,
+    'nested': nested_workload,
+    'wide': wide_workload,
+    'straight': straight_workload,
+    'synthetic': synthetic_workload
+}
+
+def write(name: str, scale: int, program_path: str, data_path: str) -> None:
+    """Write the program and data of a workload to files.
+
+    Args:
+        name: The name of the workload in WORKLOADS.
+        scale: The scale of the workload.
+        program_path: The path of the file to write the program to.
+        data_path: The path of the file to write the data to, one
+            integer per line.
+    """
+    program, data = WORKLOADS[name](scale)
+    with open(program_path, 'w') as file:
+        file.write(program)
+    with open(data_path, 'w') as file:
+        file.write(''.join('{0}\n'.format(value) for value in data))
+
+def main() -> None:
+    """Write a workload to the files named by the command line."""
+    parser = argparse.ArgumentParser()
+    parser.add_argument('workload', choices = list(WORKLOADS),
+                        help = 'the workload to generate')
+    parser.add_argument('program',
+                        help = 'the path of the file to write the Core '
+                               'program to')
+    parser.add_argument('data',
+                        help = 'the path of the file to write its data to')
+    parser.add_argument('--scale', type = int, default = 1, metavar = 'N',
+                        help = 'the factor that the size of the workload is '
+                               'multiplied by (default: 1)')
+    args = parser.parse_args()
+    if args.scale <= 0:
+        parser.error('--scale must be positive')
+    write(args.workload, args.scale, args.program, args.data)
+
+if __name__ == '__main__':
+    main()
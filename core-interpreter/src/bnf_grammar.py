@@ -15,13 +15,24 @@ abstract parse tree (APT) that is wholly encapsulated in an instance of
 the Prog class. Consequently, the classes herein are not intended to be 
 exported individually. The "print" and "execute/evaluate" methods use 
 the parse tree to pretty-print and execute the Core program, 
-respectively.
+respectively; the "print" methods append text to the listing of the 
+Prog class, which Prog.print writes in a single call and the render 
+function returns for any node. The "record" and "compile" methods let 
+the execution engines of the jit module record paths through the APT 
+and translate paths or whole loops to Python code, and the "analyze", 
+"refine", and "bounds" methods let the ranges module abstractly 
+interpret it. The "specialize" methods let the specialize module 
+partially evaluate it, and the "summarize" methods let the memo module 
+summarize loops.
 """
 
 import sys
-from typing import NoReturn, TextIO
+from typing import Callable, NoReturn, TextIO
 
 import __main__
+import output
+
+RESOURCE_LIMIT_EXIT_CODE = 3
 
 def context_free_error_checker(expected_token_number: int = 0,
                                expected_token_type: str = 'multiple') -> None:
@@ -109,21 +120,25 @@ def runtime_error(data: TextIO, error_cause: str, invalid_line: int | str = '',
     Core program, and terminate the Core interpreter.
 
     Args:
-        data: An instance of io.TextIOWrapper that provides high-level 
-            access to the buffered binary stream containing input data 
-            for "read" statements in the Core program.
+        data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+            instance, whose next_value() method returns the next input 
+            value for a "read" statement in the Core program, and whose 
+            fail() method reports why there is none.
         error_cause: The cause of the runtime error that resulted in a 
             call to this function.
         invalid_line: A line number or contents of a line to reference 
             in a message printed to stderr.
-        name: The name of an identifier to reference in a message 
-            printed to stderr.
+        name: The name of an identifier or the description of a 
+            resource limit to reference in a message printed to stderr.
 
     Raises:
         SystemExit: Print a message to stderr, and exit the Python 
-            interpreter.
+            interpreter, with RESOURCE_LIMIT_EXIT_CODE as the exit 
+            status if a resource limit was exceeded.
     """
     data.close()
+    if Prog.output:
+        Prog.output.flush()
     if error_cause == 'input eof':
         sys.exit("Runtime error! End of data file \"{0}\" has been "
                               "reached!".format(data.name))
@@ -138,6 +153,54 @@ def runtime_error(data: TextIO, error_cause: str, invalid_line: int | str = '',
                               " \"{2}\" has not been initialized!"
                               .format(__main__.tokenizer.get_file_name(),
                                       invalid_line, name))
+    if error_cause == 'infinite loop':
+        sys.exit("Runtime error! File \"{0}\", line {1}: infinite loop "
+                              "detected!"
+                              .format(__main__.tokenizer.get_file_name(),
+                                      invalid_line))
+    if error_cause == 'resource limit':
+        print("Runtime error! File \"{0}\", line {1}: {2} exceeded!"
+              .format(__main__.tokenizer.get_file_name(), invalid_line, name),
+              file = sys.stderr)
+        sys.exit(RESOURCE_LIMIT_EXIT_CODE)
+
+def render(node: object) -> str:
+    """Return the pretty-printed text of an APT node.
+
+    Args:
+        node: An instance of a class herein other than Prog, whose 
+            print() method appends its text to the listing of the Prog 
+            class instead of printing it.
+    """
+    Prog.listing = []
+    node.print()
+    text = ''.join(Prog.listing)
+    Prog.listing = []
+    return text
+
+def instrument(node_class: type, method: str, enabled: object) -> None:
+    """Install the plain or the instrumented version of a node method.
+
+    The hooks of an execution are the governor, metrics, profiler, 
+    coverage, tracer, and memory attributes of Prog, and the engine 
+    and cycle_detector attributes of Loop. Each of them is None unless 
+    an instance of the class of its feature has been assigned to it, 
+    and a feature whose hook is None records nothing and pays nothing: 
+    the plain version of a method executes the APT alone, the 
+    instrumented one also calls the hooks assigned, and the code 
+    compiled by the jit module only includes the hooks assigned when it 
+    is compiled. The only remaining cost of a hook that is None is an 
+    attribute test where a "read" or "write" statement, or the 
+    recording of the trace engine, checks it.
+
+    Args:
+        node_class: A class herein that defines plain_METHOD and 
+            instrumented_METHOD.
+        method: The name of the method.
+        enabled: Whether any hook of the method is assigned.
+    """
+    setattr(node_class, method, getattr(
+        node_class, ('instrumented_' if enabled else 'plain_') + method))
 
 class Prog:
     """Encapsulation of the production for the <prog> nonterminal.
@@ -150,10 +213,20 @@ class Prog:
             parse
             print
             execute
+            analyze
+            specialize
     """
 
     decl_seq_path = True
     pretty_print_indent = ' ' * 2
+    governor = None
+    output = None
+    metrics = None
+    profiler = None
+    coverage = None
+    tracer = None
+    memory = None
+    listing = []
 
     def parse(self) -> None:
         """Construct the children of the root of the APT.
@@ -180,29 +253,121 @@ class Prog:
         context_free_error_checker(__main__.core.enums.StopToken['EOF'].value,
                                    'eof')
 
-    def print(self) -> None:
-        """Print the production of the <prog> nonterminal to stdout.
+    def print(self, file: TextIO | None = None) -> None:
+        """Print the production of the <prog> nonterminal to a file.
 
-        Print the terminals in the production of <prog>, calling print()
-        methods of the class instances representing the nonterminals of 
-        the current level that were constructed during parsing to 
-        initiate printing at the next level of the APT.
+        Append the terminals in the production of <prog> to the 
+        listing, calling print() methods of the class instances 
+        representing the nonterminals of the current level that were 
+        constructed during parsing to initiate printing at the next 
+        level of the APT, and write the whole listing to the file in a 
+        single call.
+
+        Args:
+            file: The text stream to print to, stdout if None.
         """
-        print('program')
+        Prog.listing = ['program\n']
         self._decl_seq.print()
-        print('begin')
+        Prog.listing.append('begin\n')
         self._stmt_seq.print()
-        print('end')
-
-    def execute(self, data: TextIO) -> None:
+        Prog.listing.append('end\n')
+        (file or sys.stdout).write(''.join(Prog.listing))
+        Prog.listing = []
+
+    def execute(self, data: TextIO,
+                governor: 'governor.ResourceGovernor | None' = None,
+                sink: 'output.Output | None' = None,
+                metrics: 'metrics.Metrics | None' = None,
+                profiler: 'profiler.LineProfiler | None' = None,
+                coverage: 'lcov.Coverage | None' = None,
+                tracer: 'flight.FlightRecorder | None' = None,
+                memory: 'memory.MemoryReport | None' = None) -> None:
         """Execute the <stmt seq> nonterminal in the <prog> production.
 
         Call the execute() method of the class instance representing the
         <stmt seq> nonterminal that was constructed during parsing to 
         initiate execution of the Core program at the next level of the 
-        <stmt seq> branch of the APT.
+        <stmt seq> branch of the APT. If a resource governor is given, 
+        then assign it to Prog.governor to bound the execution. The 
+        values written are buffered in Prog.output, which is flushed 
+        when the execution ends. If metrics are given, then assign them 
+        to Prog.metrics to count the statements executed and the values 
+        read and written, and if a profiler is given, then assign it to 
+        Prog.profiler to count and time the statements of every line. 
+        If a coverage is given, then assign it to Prog.coverage, and arm 
+        its probes, and if a flight recorder is given, then assign it to 
+        Prog.tracer to record the most recent events. If a memory report 
+        is given, then assign it to Prog.memory to account for the 
+        allocations of the statements of every line. The instrumented 
+        versions of the methods of the nodes are installed only where 
+        one of their hooks is assigned, and on the nodes whose coverage 
+        probes are armed.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+            governor: The resource governor whose limits end the run 
+                when exceeded, or None for no limits.
+            sink: The output that the values written are sent to, or None 
+                for the text format on stdout.
+            metrics: The metrics that count the execution, or None.
+            profiler: The line profiler of the execution, or None.
+            coverage: The coverage of the execution, or None.
+            tracer: The flight recorder of the execution, or None.
+            memory: The memory report of the execution, or None.
         """
-        self._stmt_seq.execute(data)
+        Prog.governor = governor
+        Prog.metrics = metrics
+        Prog.profiler = profiler
+        Prog.coverage = coverage
+        Prog.tracer = tracer
+        Prog.memory = memory
+        Prog.output = sink or output.TextOutput()
+        instrument(Stmt, 'execute', metrics or profiler or memory)
+        instrument(Cond, 'evaluate', tracer)
+        instrument(Assign, 'execute', governor or tracer)
+        instrument(In, 'execute', tracer)
+        instrument(Out, 'execute', tracer)
+        instrument(Loop, 'execute', Loop.engine or Loop.cycle_detector 
+                   or governor or profiler)
+        if governor:
+            governor.start()
+        if profiler:
+            profiler.start()
+        if coverage:
+            coverage.start(self)
+        if tracer:
+            tracer.start(self)
+        try:
+            self._stmt_seq.execute(data)
+        finally:
+            if profiler:
+                profiler.stop()
+            if coverage:
+                coverage.stop()
+            if tracer:
+                tracer.stop()
+            Prog.output.flush()
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis') -> None:
+        """Analyze the <stmt seq> nonterminal in the <prog> production.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+        """
+        self._stmt_seq.analyze(analysis, {})
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize the <stmt seq> nonterminal in the <prog> production.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        self._stmt_seq.specialize(specializer)
 
 class DeclSeq:
     """Encapsulation of the production for the <decl seq> nonterminal.
@@ -239,13 +404,13 @@ class DeclSeq:
             self._decl_seq.parse()
 
     def print(self) -> None:
-        """Print the parsed alternator of <decl seq> to stdout.
+        """Print the parsed alternator of <decl seq> to the listing.
 
         Call print() methods of the class instances representing the 
         nodes at the current level that were constructed during parsing 
         to initiate printing at the next level of the APT.
         """
-        print(Prog.pretty_print_indent, end = '')
+        Prog.listing.append(Prog.pretty_print_indent)
         self._decl.print()
         if self._decl_seq:
             self._decl_seq.print()
@@ -281,16 +446,16 @@ class Decl:
             __main__.core.enums.Token['SEMICOLON'].value, 'special symbol')
 
     def print(self) -> None:
-        """Print the production of the <decl> nonterminal to stdout.
+        """Print the production of the <decl> nonterminal to the listing.
 
         Print the terminals in the production of <decl>, calling the 
         print() method of the class instance representing the 
         nonterminal at the current level that was constructed during 
         parsing to initiate printing at the next level of the APT.
         """
-        print('int ', end = '')
+        Prog.listing.append('int ')
         self._id_list.print()
-        print(';')
+        Prog.listing.append(';\n')
 
 class IdList:
     """Encapsulation of the production for the <id list> nonterminal.
@@ -304,6 +469,8 @@ class IdList:
             parse
             print
             execute
+            analyze
+            get_ids
     """
 
     _is_output = False
@@ -311,6 +478,7 @@ class IdList:
     def __init__(self, line_number: int | None  = None) -> None:
         self._id_list = None
         self._line = line_number
+        self._ids = []
 
     def parse(self) -> None:
         """Construct the children of an <id list> node in the APT.
@@ -324,14 +492,16 @@ class IdList:
         """
         self._id = Id.parse()
         self._id.line[self._line] = __main__.tokenizer.line_number
+        self._prefix = self._id.get_name() + ' = '
         token_number = __main__.tokenizer.get_token()
         if token_number == __main__.core.enums.Token['COMMA'].value:
             __main__.tokenizer.skip_token()
             self._id_list = IdList(self._line)
             self._id_list.parse()
+        self._ids = self.get_ids()
 
     def print(self) -> None:
-        """Print the parsed alternator of <id list> to stdout.
+        """Print the parsed alternator of <id list> to the listing.
 
         Print the terminals in the parsed alternator of <id list>, 
         calling the print() methods of the class instances representing 
@@ -341,7 +511,7 @@ class IdList:
         """
         self._id.print()
         if self._id_list:
-            print(', ', end = '')
+            Prog.listing.append(', ')
             self._id_list.print()
 
     def execute(self, data: TextIO, is_input: bool, line_number: int) -> None:
@@ -349,25 +519,24 @@ class IdList:
 
         Perform input/output operations based on whether the caller is
         encapsulated in an instance of the In or Out class. If the 
-        caller is a member of In, then read a line from the data 
-        stream, convert the string representation of the integer in the 
-        line to an int object, and pass the int to the set_value() 
-        method of the Id object that was returned during parsing of the 
-        current node. Call the modular runtime_error() method if the 
-        current line in the data stream is the end of the file or empty 
-        or it contains string representations of non-integers. If the 
-        caller is a member of Out, then print the name and value of the 
-        Id object that was returned during parsing to stdout. If a 
-        class instance representing the <id list> nonterminal was 
-        constructed during parsing, then call its execute() method to 
-        initiate execution of the Core program at the next level of the 
-        current <stmt seq> branch of the APT.
+        caller is a member of In, then pass the next integer of the 
+        data file to the set_value() method of every Id object in the 
+        <id list>, in order; the fail() method of the data file calls 
+        the modular runtime_error() method if the current line is the 
+        end of the file or empty or it contains string representations 
+        of non-integers. If the caller is a member of Out, then send 
+        the name and value of the Id object that was returned during 
+        parsing to the buffered output in Prog.output, and if a class 
+        instance representing the <id list> nonterminal was constructed 
+        during parsing, then call its execute() method to initiate 
+        execution of the Core program at the next level of the current 
+        <stmt seq> branch of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             is_input: A value of True indicates the caller is a member 
                 of an In object; False indicates the caller is a member 
                 of an Out object.
@@ -378,26 +547,59 @@ class IdList:
                 Core program.
         """
         if is_input:
-            line = data.readline()
-            if not line:
-                runtime_error(data, 'input eof')
-            if line == '\n':
-                runtime_error(data, 'input empty line')
+            if Prog.metrics:
+                Prog.metrics.reads += len(self._ids)
             try:
-                value = int(line)
-            except ValueError:
-                runtime_error(data, 'input invalid line', line)
-            self._id.set_value(value)
+                for identifier in self._ids:
+                    identifier.set_value(data.next_value())
+            except StopIteration:
+                data.fail()
+            return
+        if not IdList._is_output:
+            IdList._is_output = True
+            header = Prog.output.header()
+            if Prog.governor:
+                Prog.governor.output(len(header), data, line_number)
+            Prog.output.append(header)
+        value = self._id.get_value(data, line_number)
+        if Prog.governor:
+            text = Prog.output.format(self._prefix, value, line_number)
+            Prog.governor.output(len(text), data, line_number)
+            Prog.output.append(text)
         else:
-            if not IdList._is_output:
-                IdList._is_output = True
-                print('\n----------Program Output----------')
-            value = self._id.get_value(data, line_number)
-            name = self._id.get_name()
-            print(name,'=',value)
+            Prog.output.write(self._prefix, value, line_number)
+        if Prog.metrics:
+            Prog.metrics.writes += 1
         if self._id_list:
             self._id_list.execute(data, is_input, line_number)
 
+    def analyze(self, analysis: 'ranges.RangeAnalysis', state: dict | None,
+                line_number: int) -> dict | None:
+        """Analyze the <id list> of a "read" statement.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+            line_number: The line whereat the "read" statement appears 
+                in the Core program.
+
+        Returns:
+            The state after every identifier has been read.
+        """
+        state = analysis.read(state, self._id, line_number)
+        if self._id_list:
+            state = self._id_list.analyze(analysis, state, line_number)
+        return state
+
+    def get_ids(self) -> list['Id']:
+        """Return the Id instances of the <id list> in order."""
+        if self._id_list:
+            return [self._id] + self._id_list.get_ids()
+        return [self._id]
+
 class Id:
     """Encapsulation of the production for the <id> nonterminal.
 
@@ -410,10 +612,16 @@ class Id:
             print
             set_value
             get_value
+            bounds
+            compile
+            save
+            restore
+            is_initialized
             get_name
 
         Public static methods:
             parse
+            get_declared
 
         Private static methods:
             _context_sensitive_error
@@ -424,6 +632,7 @@ class Id:
     def __init__(self, name: str) -> None:
         self._name = name
         self._initialized = False
+        self._value = None
         self.line = {}
 
     @staticmethod
@@ -465,8 +674,8 @@ class Id:
         Id._context_sensitive_error(id_name)
 
     def print(self) -> None:
-        """Print the name of this Id instance to stdout."""
-        print(self._name, end = '')
+        """Print the name of this Id instance to the listing."""
+        Prog.listing.append(self._name)
 
     def set_value(self, value: int) -> None:
         """Associate a value with this Id instance.
@@ -482,10 +691,10 @@ class Id:
         """Return the value of this Id instance.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose execute() method resulted in a 
@@ -501,6 +710,37 @@ class Id:
             runtime_error(data, 'uninitialized identifier', 
                           self.line[line_number], self._name)
 
+    def bounds(self, analysis: 'ranges.RangeAnalysis',
+               state: dict) -> 'ranges.Interval':
+        """Return the interval of this Id instance in a state."""
+        return analysis.lookup(state, self)
+
+    def compile(self, names: dict['Id', str]) -> str:
+        """Return the Python expression that holds this Id's value.
+
+        Args:
+            names: A dict whose keys are Id instances and whose values 
+                are the Python expressions that hold their values. 
+        """
+        return names[self]
+
+    def save(self) -> tuple[bool, int | None]:
+        """Return the initialization and value of this Id instance."""
+        return self._initialized, self._value
+
+    def restore(self, saved: tuple[bool, int | None]) -> None:
+        """Restore a state of this Id instance returned by save().
+
+        Args:
+            saved: A tuple of whether this Id instance is initialized 
+                and its value.
+        """
+        self._initialized, self._value = saved
+
+    def is_initialized(self) -> bool:
+        """Return whether a value is associated with this Id instance."""
+        return self._initialized
+
     def get_name(self) -> str:
         """Return the name of this Id instance.
 
@@ -510,6 +750,11 @@ class Id:
         """
         return self._name
 
+    @staticmethod
+    def get_declared() -> list['Id']:
+        """Return the declared Id instances in order of declaration."""
+        return Id._declared_ids
+
     @staticmethod 
     def _context_sensitive_error(id_name: str) -> NoReturn:
         """Terminate the program because of context-sensitive errors.
@@ -551,6 +796,11 @@ class StmtSeq:
             parse
             print
             execute
+            record
+            compile
+            analyze
+            specialize
+            summarize
     """
 
     def __init__(self, indent_level: int) -> None:
@@ -578,13 +828,13 @@ class StmtSeq:
             self._stmt_seq.parse()
 
     def print(self) -> None:
-        """Print a parsed alternator of <stmt seq> to stdout.
+        """Print a parsed alternator of <stmt seq> to the listing.
 
         Call print() methods of the class instances representing the 
         nodes at the current level that were constructed during parsing 
         to initiate printing at the next level of the APT.
         """
-        print(Prog.pretty_print_indent * self._indent_level, end = '')
+        Prog.listing.append(Prog.pretty_print_indent * self._indent_level)
         self._stmt.print()
         if self._stmt_seq:
             self._stmt_seq.print()
@@ -598,15 +848,110 @@ class StmtSeq:
         the Core program at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         self._stmt.execute(data)
         if self._stmt_seq:
             self._stmt_seq.execute(data)
-        
+
+    def record(self, data: TextIO, trace: 'jit.Trace',
+               exits: tuple['StmtSeq', ...]) -> None:
+        """Execute a parsed alternator of <stmt seq>, and record it.
+
+        Execute the <stmt seq> node exactly as execute() does while 
+        appending the operations performed to a trace. The <stmt seq> 
+        nodes that remain to be executed after each <stmt> node are 
+        passed along so that a trace can resume the tree-walk at any 
+        point of its path.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+            trace: The trace that the executed operations are appended 
+                to.
+            exits: The <stmt seq> nodes that must be executed, in 
+                order, after this node to complete the traced iteration.
+        """
+        if self._stmt_seq:
+            self._stmt.record(data, trace, (self._stmt_seq,) + exits)
+            self._stmt_seq.record(data, trace, exits)
+        else:
+            self._stmt.record(data, trace, exits)
+
+    def compile(self, compiler: 'jit.LoopCompiler',
+                exits: tuple['StmtSeq | Loop', ...]) -> None:
+        """Translate a parsed alternator of <stmt seq> to Python code.
+
+        Should the compiled code have to leave before the <stmt> node, 
+        this node followed by the nodes in exits resumes the tree-walk 
+        at the <stmt> node.
+
+        Args:
+            compiler: The compiler that the translated statements are 
+                emitted to.
+            exits: The nodes that must be executed, in order, after 
+                this node to complete the compiled iteration.
+        """
+        compiler.resume = (self,) + exits
+        if self._stmt_seq:
+            self._stmt.compile(compiler, (self._stmt_seq,) + exits)
+            self._stmt_seq.compile(compiler, exits)
+        else:
+            self._stmt.compile(compiler, exits)
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis',
+                state: dict | None) -> dict | None:
+        """Analyze a parsed alternator of <stmt seq>.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+
+        Returns:
+            The state after this node.
+        """
+        state = self._stmt.analyze(analysis, state)
+        if self._stmt_seq:
+            state = self._stmt_seq.analyze(analysis, state)
+        return state
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize a parsed alternator of <stmt seq>.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        self._stmt.specialize(specializer)
+        if self._stmt_seq:
+            self._stmt_seq.specialize(specializer)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of a parsed alternator of <stmt seq>.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        assigned = self._stmt.summarize(summary, assigned)
+        if self._stmt_seq:
+            assigned = self._stmt_seq.summarize(summary, assigned)
+        return assigned
+
 class Stmt:
     """Encapsulation of the production for the <stmt> nonterminal.
 
@@ -618,7 +963,16 @@ class Stmt:
             __init__
             parse
             print
+            plain_execute
+            instrumented_execute
             execute
+            record
+            compile
+            analyze
+            specialize
+            summarize
+            get_line
+            set_probed
     """
 
     def __init__(self, indent_level: int) -> None:
@@ -628,6 +982,8 @@ class Stmt:
         self._input = None
         self._output = None
         self._indent_level = indent_level
+        self._line = None
+        self._probed = False
 
     def parse(self) -> None:
         """Construct the children of a <stmt> node in the APT.
@@ -640,6 +996,7 @@ class Stmt:
         next level of the APT. 
         """
         token_number = __main__.tokenizer.get_token()
+        self._line = __main__.tokenizer.line_number
         if token_number == __main__.core.enums.Token['IDENTIFIER'].value:
             self._assign = Assign()
             self._assign.parse()
@@ -659,7 +1016,7 @@ class Stmt:
             context_free_error_checker()
 
     def print(self) -> None:
-        """Print an alternator of the <stmt> nonterminal to stdout.
+        """Print an alternator of the <stmt> nonterminal to the listing.
 
         Call the print() method of the class instance representing the 
         node at the current level that was constructed during parsing 
@@ -676,7 +1033,7 @@ class Stmt:
         if self._output:
             self._output.print()
 
-    def execute(self, data: TextIO) -> None:
+    def plain_execute(self, data: TextIO) -> None:
         """Execute a parsed alternator of the <stmt> production.
 
         Call the execute() method of the class instance representing 
@@ -685,10 +1042,10 @@ class Stmt:
         the Core program at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         if self._assign:
             self._assign.execute(data)
@@ -701,6 +1058,196 @@ class Stmt:
         if self._output:
             self._output.execute(data)
 
+    def instrumented_execute(self, data: TextIO) -> None:
+        """Execute a parsed alternator of <stmt>, and call its hooks.
+
+        If metrics have been assigned to Prog.metrics, then count the 
+        execution. If a profiler has been assigned to Prog.profiler, 
+        then count the execution toward the line of this node, and 
+        mark its start and end. If the coverage probe of this node is 
+        armed, then fire it, and if a memory report has been assigned 
+        to Prog.memory, then account for the allocations of this node 
+        toward its line.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+        """
+        if Prog.metrics:
+            Prog.metrics.statements += 1
+        if self._probed and Prog.coverage:
+            self.set_probed(Prog.coverage.fire(self))
+        if Prog.profiler:
+            Prog.profiler.enter(self._line)
+        if Prog.memory:
+            Prog.memory.enter(self._line)
+        if self._assign:
+            self._assign.execute(data)
+        if self._if:
+            self._if.execute(data)
+        if self._loop:
+            self._loop.execute(data)
+        if self._input:
+            self._input.execute(data)
+        if self._output:
+            self._output.execute(data)
+        if Prog.memory:
+            Prog.memory.leave()
+        if Prog.profiler:
+            Prog.profiler.leave()
+
+    execute = plain_execute
+
+    def record(self, data: TextIO, trace: 'jit.Trace',
+               exits: tuple['StmtSeq', ...]) -> None:
+        """Execute a parsed alternator of <stmt>, and record it.
+
+        Assignments and conditional branches are recorded as operations
+        of the trace. Loops, "read" statements, and "write" statements 
+        are recorded as calls back into the tree-walk.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+            trace: The trace that the executed operations are appended 
+                to.
+            exits: The <stmt seq> nodes that must be executed, in 
+                order, after this node to complete the traced iteration.
+        """
+        if Prog.metrics:
+            Prog.metrics.statements += 1
+        if Prog.profiler:
+            Prog.profiler.walked[self._line] += 1
+        if Prog.memory:
+            Prog.memory.statements[self._line] += 1
+        if self._probed and Prog.coverage:
+            self.set_probed(Prog.coverage.fire(self))
+        if self._assign:
+            self._assign.record(data, trace)
+        if self._if:
+            self._if.record(data, trace, exits)
+        if self._loop:
+            trace.call(self._loop)
+            self._loop.execute(data)
+        if self._input:
+            trace.call(self._input)
+            self._input.execute(data)
+        if self._output:
+            trace.call(self._output)
+            self._output.execute(data)
+
+    def compile(self, compiler: 'jit.LoopCompiler',
+                exits: tuple['StmtSeq | Loop', ...]) -> None:
+        """Translate a parsed alternator of <stmt> to Python code.
+
+        "read" and "write" statements are translated to calls into the 
+        tree-walk.
+
+        Args:
+            compiler: The compiler that the translated statements are 
+                emitted to.
+            exits: The nodes that must be executed, in order, after 
+                this node to complete the compiled iteration.
+        """
+        if self._assign:
+            self._assign.compile(compiler)
+        if self._if:
+            self._if.compile(compiler, exits)
+        if self._loop:
+            self._loop.compile(compiler, exits)
+        if self._input:
+            compiler.call(self._input)
+        if self._output:
+            compiler.call(self._output)
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis',
+                state: dict | None) -> dict | None:
+        """Analyze a parsed alternator of <stmt>.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+
+        Returns:
+            The state after this node.
+        """
+        if self._assign:
+            state = self._assign.analyze(analysis, state)
+        if self._if:
+            state = self._if.analyze(analysis, state)
+        if self._loop:
+            state = self._loop.analyze(analysis, state)
+        if self._input:
+            state = self._input.analyze(analysis, state)
+        return state
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize a parsed alternator of <stmt>.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        if self._assign:
+            self._assign.specialize(specializer)
+        if self._if:
+            self._if.specialize(specializer)
+        if self._loop:
+            self._loop.specialize(specializer)
+        if self._input:
+            self._input.specialize(specializer)
+        if self._output:
+            self._output.specialize(specializer)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of a parsed alternator of <stmt>.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        if self._assign:
+            return self._assign.summarize(summary, assigned)
+        if self._if:
+            return self._if.summarize(summary, assigned)
+        if self._loop:
+            return self._loop.summarize(summary, assigned)
+        if self._input:
+            return self._input.summarize(summary, assigned)
+        if self._output:
+            return self._output.summarize(summary, assigned)
+
+    def get_line(self) -> int:
+        """Return the line whereat this <stmt> appears in the program."""
+        return self._line
+
+    def set_probed(self, probed: bool) -> None:
+        """Arm or disarm the coverage probe of this node.
+
+        An armed node executes through instrumented_execute() until its 
+        probe fires, and a disarmed one through the execute() method 
+        that instrument() installed on the class, so that a statement 
+        that has been covered pays nothing for the coverage.
+        """
+        if probed:
+            self.execute = self.instrumented_execute
+        elif self._probed:
+            del self.execute
+        self._probed = probed
+
 class In:
     """Encapsulation of the production for the <in> nonterminal.
 
@@ -711,7 +1258,13 @@ class In:
         Public instance methods:
             parse
             print
+            plain_execute
+            instrumented_execute
             execute
+            analyze
+            specialize
+            summarize
+            get_line
     """
 
     def parse(self) -> None:
@@ -735,18 +1288,18 @@ class In:
             __main__.core.enums.Token['SEMICOLON'].value, 'special symbol')
 
     def print(self) -> None:
-        """Print the production of the <in> nonterminal to stdout.
+        """Print the production of the <in> nonterminal to the listing.
 
         Print the terminals in the production of <in>, calling the 
         print() method of the class instance representing the 
         nonterminal at the current level that was constructed during 
         parsing to initiate printing at the next level of the APT.
         """
-        print('read ', end = '')
+        Prog.listing.append('read ')
         self._id_list.print()
-        print(';')
+        Prog.listing.append(';\n')
     
-    def execute(self, data: TextIO) -> None:
+    def plain_execute(self, data: TextIO) -> None:
         """Execute the <id list> nonterminal in the <in> production.
 
         Call the execute() method of the class instance representing 
@@ -755,13 +1308,77 @@ class In:
         the Core program at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         self._id_list.execute(data, is_input = True, line_number = self._line)
 
+    def instrumented_execute(self, data: TextIO) -> None:
+        """Execute the <in> production, and record the values read.
+
+        The values are recorded in the flight recorder assigned to 
+        Prog.tracer.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+        """
+        self._id_list.execute(data, is_input = True, line_number = self._line)
+        Prog.tracer.read(self, self._id_list.get_ids())
+
+    execute = plain_execute
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis',
+                state: dict | None) -> dict | None:
+        """Analyze the <id list> nonterminal in the <in> production.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+
+        Returns:
+            The state after this node.
+        """
+        return self._id_list.analyze(analysis, state, self._line)
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize the <id list> nonterminal in the <in> production.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        specializer.read(self._id_list.get_ids(), self._line)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of the production of <in>.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        summary.perform_io()
+        for identifier in self._id_list.get_ids():
+            assigned = summary.define(identifier, assigned)
+        return assigned
+
+    def get_line(self) -> int:
+        """Return the line whereat this <in> appears in the program."""
+        return self._line
+
 class Out:
     """Encapsulation of the production for the <out> nonterminal.
 
@@ -772,7 +1389,12 @@ class Out:
         Public instance methods:
             parse
             print
+            plain_execute
+            instrumented_execute
             execute
+            specialize
+            summarize
+            get_line
     """
 
     def parse(self) -> None:
@@ -795,18 +1417,18 @@ class Out:
             __main__.core.enums.Token['SEMICOLON'].value, 'special symbol')
 
     def print(self) -> None:
-        """Print the production of the <out> nonterminal to stdout.
+        """Print the production of the <out> nonterminal to the listing.
 
         Print the terminals in the production of <out>, calling the 
         print() method of the class instance representing the 
         nonterminal at the current level that was constructed during 
         parsing to initiate printing at the next level of the APT.
         """
-        print('write ', end = '')
+        Prog.listing.append('write ')
         self._id_list.print()
-        print(';')
+        Prog.listing.append(';\n')
 
-    def execute(self, data: TextIO) -> None:
+    def plain_execute(self, data: TextIO) -> None:
         """Execute the <id list> nonterminal in the <out> production.
 
         Call the execute() method of the class instance representing 
@@ -815,13 +1437,59 @@ class Out:
         the Core program at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         self._id_list.execute(data, is_input = False, line_number = self._line)
 
+    def instrumented_execute(self, data: TextIO) -> None:
+        """Execute the <out> production, and record the values written.
+
+        The values are recorded in the flight recorder assigned to 
+        Prog.tracer.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+        """
+        self._id_list.execute(data, is_input = False, line_number = self._line)
+        Prog.tracer.write(self, self._id_list.get_ids())
+
+    execute = plain_execute
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize the <id list> nonterminal in the <out> production.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        specializer.write(self._id_list.get_ids(), self._line)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of the production of <out>.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        summary.perform_io()
+        return assigned
+
+    def get_line(self) -> int:
+        """Return the line whereat this <out> appears in the program."""
+        return self._line
+
 class Loop:
     """Encapsulation of the production for the <loop> nonterminal.
 
@@ -833,11 +1501,26 @@ class Loop:
             __init__
             parse
             print
+            plain_execute
+            instrumented_execute
             execute
+            compile
+            analyze
+            specialize
+            summarize
+            watch
+            get_condition
+            get_stmt_seq
+            get_line
+            set_probed
     """
 
+    engine = None
+    cycle_detector = None
+
     def __init__(self, indent_level: int) -> None:
         self._indent_level = indent_level
+        self._probed = False
 
     def parse(self) -> None:
         """Construct the children of a <loop> node in the APT.
@@ -865,22 +1548,22 @@ class Loop:
             __main__.core.enums.Token['SEMICOLON'].value, 'special symbol')
 
     def print(self) -> None:
-        """Print the production of the <loop> nonterminal to stdout.
+        """Print the production of the <loop> nonterminal to the listing.
 
         Print the terminals in the production of <loop>, calling the 
         print() method of the class instances representing the 
         nonterminals at the current level that were constructed during 
         parsing to initiate printing at the next level of the APT.
         """
-        print('while ', end = '')
+        Prog.listing.append('while ')
         self._condition.print()
-        print('')
-        print(Prog.pretty_print_indent * (self._indent_level + 1), 
-              'loop', sep = '')
+        Prog.listing.append('\n' + Prog.pretty_print_indent 
+                            * (self._indent_level + 1) + 'loop\n')
         self._stmt_seq.print()
-        print(Prog.pretty_print_indent * self._indent_level, 'end;', sep = '')
+        Prog.listing.append(Prog.pretty_print_indent * self._indent_level
+                            + 'end;\n')
     
-    def execute(self, data: TextIO) -> None:
+    def plain_execute(self, data: TextIO) -> None:
         """Execute the nonterminals in the <loop> production.
 
         Evaluate the <cond> node that was constructed during parsing to 
@@ -891,14 +1574,165 @@ class Loop:
         at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         while self._condition.evaluate(data, self._line):
             self._stmt_seq.execute(data)
 
+    def instrumented_execute(self, data: TextIO) -> None:
+        """Execute the <loop> production with an engine or its checks.
+
+        If an execution engine has been assigned to Loop.engine, then 
+        delegate the loop to it, and have the profiler, if any, time 
+        the engine. Otherwise, execute it as plain_execute() does, and 
+        call the function returned by watch(), if any, at every header. 
+        If the coverage probe of this node is armed, then fire it once 
+        the loop has exited.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+        """
+        if Loop.engine:
+            if Prog.profiler:
+                Prog.profiler.enter_engine(self._line)
+            Loop.engine.execute_loop(self, data)
+            if Prog.profiler:
+                Prog.profiler.leave()
+        else:
+            header = self.watch()
+            while self._condition.evaluate(data, self._line):
+                if header:
+                    header(data)
+                self._stmt_seq.execute(data)
+        if self._probed and Prog.coverage:
+            self.set_probed(Prog.coverage.exit(self))
+
+    execute = plain_execute
+
+    def compile(self, compiler: 'jit.LoopCompiler',
+                exits: tuple['StmtSeq | Loop', ...]) -> None:
+        """Translate the production of <loop> to Python code.
+
+        Should the compiled code have to leave before the <cond> node 
+        is evaluated, this node followed by the nodes in exits resumes 
+        the tree-walk at the loop header.
+
+        Args:
+            compiler: The compiler that the translated statements are 
+                emitted to.
+            exits: The nodes that must be executed, in order, after 
+                this node to complete the compiled iteration.
+        """
+        compiler.loop(self, (self,) + exits)
+        self._stmt_seq.compile(compiler, (self,) + exits)
+        compiler.end()
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis',
+                state: dict | None) -> dict | None:
+        """Analyze the production of <loop>.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+
+        Returns:
+            The state after this node.
+        """
+        return analysis.loop(self, state)
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize the production of <loop>.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        specializer.loop(self)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of the production of <loop>.
+
+        The <stmt seq> node may not be executed, so the identifiers it 
+        assigns are not assigned on every path through this node.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        summary.use(self._condition, assigned)
+        self._stmt_seq.summarize(summary, assigned)
+        return assigned
+
+    def watch(self) -> Callable[[TextIO], None] | None:
+        """Return the check of the headers of an execution of this loop.
+
+        If a cycle detector has been assigned to Loop.cycle_detector, 
+        then the check searches the identifiers of the loop for a 
+        cycle, if a resource governor has been assigned to 
+        Prog.governor, then it counts the back-edge toward the limits, 
+        and if a profiler has been assigned to Prog.profiler, then it 
+        counts the iteration toward the line of this node.
+
+        Returns:
+            A function of the data stream to call at every header whose 
+            <cond> node resolved to True, or None if nothing checks the 
+            loop.
+        """
+        cycle = Loop.cycle_detector and Loop.cycle_detector.watch(self)
+        governor = Prog.governor
+        checks = [check for check in (
+                      cycle and cycle.header,
+                      governor and (lambda data: governor.back_edge(
+                          data, self._line)),
+                      Prog.profiler and Prog.profiler.header(self._line))
+                  if check]
+        if len(checks) > 1:
+            def header(data: TextIO) -> None:
+                for check in checks:
+                    check(data)
+            return header
+        return checks[0] if checks else None
+
+    def get_condition(self) -> 'Cond':
+        """Return the <cond> node of the <loop> production."""
+        return self._condition
+
+    def get_stmt_seq(self) -> 'StmtSeq':
+        """Return the <stmt seq> node of the <loop> production."""
+        return self._stmt_seq
+
+    def get_line(self) -> int:
+        """Return the line whereat this <loop> appears in the program."""
+        return self._line
+
+    def set_probed(self, probed: bool) -> None:
+        """Arm or disarm the coverage probe of the exit of this loop.
+
+        An armed node executes through instrumented_execute(), once 
+        per execution of the loop rather than once per iteration, until 
+        the loop has exited, as Stmt.set_probed() describes.
+        """
+        if probed:
+            self.execute = self.instrumented_execute
+        elif self._probed:
+            del self.execute
+        self._probed = probed
+
 class If:
     """Encapsulation of the production for the <if> nonterminal.
 
@@ -912,6 +1746,12 @@ class If:
             parse
             print
             execute
+            record
+            compile
+            analyze
+            specialize
+            summarize
+            get_condition
     """
 
     def __init__(self, indent_level: int) -> None:
@@ -953,22 +1793,23 @@ class If:
             __main__.core.enums.Token['SEMICOLON'].value, 'special symbol')
 
     def print(self) -> None:
-        """Print an alternator of the <if> production to stdout.
+        """Print an alternator of the <if> production to the listing.
 
         Print the terminals in the parsed alternator of <if>, calling 
         the print() method of the class instances representing the 
         nonterminals at the current level that were constructed during 
         parsing to initiate printing at the next level of the APT.
         """
-        print('if ', end = '')
+        Prog.listing.append('if ')
         self._condition.print()
-        print(' then')
+        Prog.listing.append(' then\n')
         self._then_stmt_seq.print()
         if self._else_stmt_seq:
-            print(Prog.pretty_print_indent * self._indent_level, 
-                  'else', sep = '')
+            Prog.listing.append(Prog.pretty_print_indent * self._indent_level
+                                + 'else\n')
             self._else_stmt_seq.print()
-        print(Prog.pretty_print_indent * self._indent_level, 'end;', sep = '')
+        Prog.listing.append(Prog.pretty_print_indent * self._indent_level
+                            + 'end;\n')
 
     def execute(self, data: TextIO) -> None:
         """Execute the nonterminals in the parsed <if> alternator.
@@ -982,10 +1823,10 @@ class If:
         initiates execution and evaluation at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         if self._condition.evaluate(data, self._line):
             self._then_stmt_seq.execute(data)
@@ -993,6 +1834,115 @@ class If:
             if self._else_stmt_seq:
                 self._else_stmt_seq.execute(data)
 
+    def record(self, data: TextIO, trace: 'jit.Trace',
+               exits: tuple['StmtSeq', ...]) -> None:
+        """Execute the parsed <if> alternator, and record its path.
+
+        Evaluate the <cond> node, and record a guard on the direction 
+        that it resolves to. Should the guard fail when the trace is 
+        replayed, the alternative <stmt seq> node (if any) followed by 
+        the nodes in exits completes the iteration in the tree-walk. 
+        Record the <stmt seq> node of the direction taken.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+            trace: The trace that the executed operations are appended 
+                to.
+            exits: The <stmt seq> nodes that must be executed, in 
+                order, after this node to complete the traced iteration.
+        """
+        if self._condition.evaluate(data, self._line):
+            if self._else_stmt_seq:
+                trace.guard(self._condition, True,
+                            (self._else_stmt_seq,) + exits)
+            else:
+                trace.guard(self._condition, True, exits)
+            self._then_stmt_seq.record(data, trace, exits)
+        else:
+            trace.guard(self._condition, False,
+                        (self._then_stmt_seq,) + exits)
+            if self._else_stmt_seq:
+                self._else_stmt_seq.record(data, trace, exits)
+
+    def compile(self, compiler: 'jit.LoopCompiler',
+                exits: tuple['StmtSeq | Loop', ...]) -> None:
+        """Translate the parsed <if> alternator to Python code.
+
+        Args:
+            compiler: The compiler that the translated statements are 
+                emitted to.
+            exits: The nodes that must be executed, in order, after 
+                this node to complete the compiled iteration.
+        """
+        compiler.branch(self._condition)
+        self._then_stmt_seq.compile(compiler, exits)
+        if self._else_stmt_seq:
+            compiler.orelse()
+            self._else_stmt_seq.compile(compiler, exits)
+        compiler.end()
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis',
+                state: dict | None) -> dict | None:
+        """Analyze the parsed <if> alternator.
+
+        Analyze each <stmt seq> node in the state narrowed by the 
+        outcome of the <cond> node that leads to it, and join the 
+        states after them.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+
+        Returns:
+            The state after this node.
+        """
+        then_state = self._then_stmt_seq.analyze(
+            analysis, self._condition.refine(analysis, state, True))
+        else_state = self._condition.refine(analysis, state, False)
+        if self._else_stmt_seq:
+            else_state = self._else_stmt_seq.analyze(analysis, else_state)
+        return analysis.join(then_state, else_state)
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize the parsed <if> alternator.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        specializer.branch(self._condition, self._then_stmt_seq,
+                           self._else_stmt_seq, self._line)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of the parsed <if> alternator.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        summary.use(self._condition, assigned)
+        then_assigned = self._then_stmt_seq.summarize(summary, assigned)
+        if self._else_stmt_seq:
+            return then_assigned & self._else_stmt_seq.summarize(summary,
+                                                                 assigned)
+        return assigned
+
+    def get_condition(self) -> 'Cond':
+        """Return the <cond> node of the <if> production."""
+        return self._condition
+
 class Cond:
     """Encapsulation of the production for the <cond> nonterminal.
 
@@ -1005,7 +1955,14 @@ class Cond:
             __init__
             parse
             print
+            plain_evaluate
+            instrumented_evaluate
             evaluate
+            compile
+            refine
+            get_line
+            set_probed
+            set_traced
     """
 
     def __init__(self, line_number: int) -> None:
@@ -1015,6 +1972,8 @@ class Cond:
         self._conjunction_right_condition = None
         self._disjunction_right_condition = None
         self._line = line_number
+        self._probed = False
+        self._traced = False
 
     def parse(self) -> None:
         """Construct the children of a <cond> node in the APT.
@@ -1057,7 +2016,7 @@ class Cond:
             context_free_error_checker()
 
     def print(self) -> None:
-        """Print an alternator of the <cond> production to stdout.
+        """Print an alternator of the <cond> production to the listing.
 
         Print the terminals in the parsed alternator of <cond>, calling 
         the print() method of the class instances representing the 
@@ -1067,22 +2026,22 @@ class Cond:
         if self._comparison:
             self._comparison.print()
         if self._not_condition:
-            print('!', end = '')
+            Prog.listing.append('!')
             self._not_condition.print()
         if self._conjunction_right_condition:
-            print('[ ', end = '')
+            Prog.listing.append('[ ')
             self._left_condition.print()
-            print(' && ', end = '')
+            Prog.listing.append(' && ')
             self._conjunction_right_condition.print()
-            print(' ]', end = '')
+            Prog.listing.append(' ]')
         if self._disjunction_right_condition:
-            print('[ ', end = '')
+            Prog.listing.append('[ ')
             self._left_condition.print()
-            print(' || ', end = '')
+            Prog.listing.append(' || ')
             self._disjunction_right_condition.print()
-            print(' ]', end = '')
+            Prog.listing.append(' ]')
 
-    def evaluate(self, data: TextIO, line_number: int) -> bool:
+    def plain_evaluate(self, data: TextIO, line_number: int) -> bool:
         """Evaluate the nonterminals in the parsed <cond> alternator.
 
         Evaluate the <cond> or <comp> nodes that were constructed 
@@ -1095,10 +2054,10 @@ class Cond:
         next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose parse() method resulted in the 
@@ -1123,6 +2082,118 @@ class Cond:
                     or self._disjunction_right_condition.evaluate(
                         data, line_number))
 
+    def instrumented_evaluate(self, data: TextIO, line_number: int) -> bool:
+        """Evaluate the <cond> production, and call its hooks.
+
+        If the coverage probe of this node is armed, then fire it with 
+        the evaluation, and if this node is traced, then record the 
+        evaluation in Prog.tracer.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+            line_number: The line whereat the <cond> node appears in 
+                the Core program.
+
+        Returns:
+            The evaluation of the <cond> node, as plain_evaluate() 
+            returns it.
+        """
+        outcome = self.plain_evaluate(data, line_number)
+        if self._probed and Prog.coverage:
+            self.set_probed(Prog.coverage.branch(self, outcome))
+        if self._traced and Prog.tracer:
+            Prog.tracer.branch(self, outcome)
+        return outcome
+
+    evaluate = plain_evaluate
+
+    def compile(self, names: dict['Id', str]) -> str:
+        """Translate the parsed <cond> alternator to a Python expression.
+
+        Args:
+            names: A dict whose keys are Id instances and whose values 
+                are the Python expressions that hold their values. 
+
+        Returns:
+            A Python expression that is equivalent to the evaluation of 
+            this Cond instance.
+        """
+        if self._comparison:
+            return self._comparison.compile(names)
+        if self._not_condition:
+            return '(not {0})'.format(self._not_condition.compile(names))
+        if self._conjunction_right_condition:
+            return '({0} and {1})'.format(
+                self._left_condition.compile(names),
+                self._conjunction_right_condition.compile(names))
+        if self._disjunction_right_condition:
+            return '({0} or {1})'.format(
+                self._left_condition.compile(names),
+                self._disjunction_right_condition.compile(names))
+
+    def refine(self, analysis: 'ranges.RangeAnalysis', state: dict | None,
+               outcome: bool) -> dict | None:
+        """Narrow a state by an outcome of the parsed <cond> alternator.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+            outcome: The Boolean that this Cond instance resolves to.
+
+        Returns:
+            The state in which this Cond instance resolves to outcome, 
+            or None if it cannot.
+        """
+        if self._comparison:
+            return self._comparison.refine(analysis, state, outcome)
+        if self._not_condition:
+            return self._not_condition.refine(analysis, state, not outcome)
+        if self._conjunction_right_condition:
+            left_true = self._left_condition.refine(analysis, state, True)
+            if outcome:
+                return self._conjunction_right_condition.refine(
+                    analysis, left_true, True)
+            return analysis.join(
+                self._left_condition.refine(analysis, state, False),
+                self._conjunction_right_condition.refine(
+                    analysis, left_true, False))
+        if self._disjunction_right_condition:
+            left_false = self._left_condition.refine(analysis, state, False)
+            if not outcome:
+                return self._disjunction_right_condition.refine(
+                    analysis, left_false, False)
+            return analysis.join(
+                self._left_condition.refine(analysis, state, True),
+                self._disjunction_right_condition.refine(
+                    analysis, left_false, True))
+
+    def get_line(self) -> int:
+        """Return the line whereat this <cond> appears in the program."""
+        return self._line
+
+    def set_probed(self, probed: bool) -> None:
+        """Arm or disarm the coverage probe of this node.
+
+        An armed node evaluates through instrumented_evaluate() until 
+        both of its outcomes have fired, as Stmt.set_probed() 
+        describes.
+        """
+        if probed:
+            self.evaluate = self.instrumented_evaluate
+        elif self._probed:
+            del self.evaluate
+        self._probed = probed
+
+    def set_traced(self, traced: bool) -> None:
+        """Start or stop recording the evaluations of this node."""
+        self._traced = traced
+
 class Comp:
     """Encapsulation of the production for the <comp> nonterminal.
 
@@ -1135,6 +2206,8 @@ class Comp:
             parse
             print
             evaluate
+            compile
+            refine
     """
 
     def __init__(self, line_number: int) -> None:
@@ -1165,18 +2238,18 @@ class Comp:
             'special symbol')
     
     def print(self) -> None:
-        """Print the production of the <comp> nonterminal to stdout.
+        """Print the production of the <comp> nonterminal to the listing.
 
         Print the terminals in the production of <comp>, calling 
         the print() method of the class instances representing the 
         nonterminals at the current level that were constructed during 
         parsing to initiate printing at the next level of the APT.
         """
-        print('( ', end = '')
+        Prog.listing.append('( ')
         self._left_operand.print()
         self._comp_operator.print()
         self._right_operand.print()
-        print(' )', end = '')
+        Prog.listing.append(' )')
 
     def evaluate(self, data: TextIO, line_number: int) -> bool:
         """Evaluate the nonterminals in the production of <comp>.
@@ -1190,10 +2263,10 @@ class Comp:
         nodes initiates evaluation at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose parse() method resulted in the 
@@ -1224,6 +2297,41 @@ class Comp:
             return (self._left_operand.evaluate(data, line_number) 
                     >= self._right_operand.evaluate(data, line_number))
 
+    def compile(self, names: dict['Id', str]) -> str:
+        """Translate the production of <comp> to a Python expression.
+
+        Args:
+            names: A dict whose keys are Id instances and whose values 
+                are the Python expressions that hold their values. 
+
+        Returns:
+            A Python expression that is equivalent to the evaluation of 
+            this Comp instance.
+        """
+        return '({0} {1} {2})'.format(self._left_operand.compile(names),
+                                      self._comp_operator.compile(),
+                                      self._right_operand.compile(names))
+
+    def refine(self, analysis: 'ranges.RangeAnalysis', state: dict | None,
+               outcome: bool) -> dict | None:
+        """Narrow a state by an outcome of the <comp> production.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+            outcome: The Boolean that this Comp instance resolves to.
+
+        Returns:
+            The state in which this Comp instance resolves to outcome, 
+            or None if it cannot.
+        """
+        return analysis.compare(state, self._left_operand,
+                                self._comp_operator.get_op_name(),
+                                self._right_operand, outcome)
+
 class CompOp:
     """Encapsulation of the production for the <comp op> nonterminal.
 
@@ -1234,6 +2342,7 @@ class CompOp:
         Public instance methods:
             parse
             print
+            compile
             get_op_name
     """
 
@@ -1259,8 +2368,12 @@ class CompOp:
         __main__.tokenizer.skip_token()
 
     def print(self) -> None:
-        """Print an alternator of the <comp op> production to stdout."""
-        print('', __main__.core.SPECIAL[self._operator], '', end = '')
+        """Print an alternator of the <comp op> production to the listing."""
+        Prog.listing.append(' ' + __main__.core.SPECIAL[self._operator] + ' ')
+
+    def compile(self) -> str:
+        """Return the Python operator equivalent to the <comp op>."""
+        return __main__.core.SPECIAL[self._operator]
 
     def get_op_name(self) -> str:
         """Return the terminal child of the <comp op> node."""
@@ -1276,7 +2389,15 @@ class Assign:
         Public instance methods:
             parse
             print
+            plain_execute
+            instrumented_execute
             execute
+            record
+            compile
+            analyze
+            specialize
+            summarize
+            get_expression
     """
 
     def parse(self) -> None:
@@ -1300,7 +2421,7 @@ class Assign:
             __main__.core.enums.Token['SEMICOLON'].value, 'special symbol')
 
     def print(self) -> None:
-        """Print the production of the <assign> nonterminal to stdout.
+        """Print the production of the <assign> nonterminal to the listing.
 
         Print the terminals in the production of <assign>, calling 
         the print() method of the class instances representing the 
@@ -1308,21 +2429,113 @@ class Assign:
         parsing to initiate printing at the next level of the APT.
         """
         self._id.print()
-        print(' = ', end = '')
+        Prog.listing.append(' = ')
         self._expression.print()
-        print(';')
+        Prog.listing.append(';\n')
 
-    def execute(self, data: TextIO) -> None:
+    def plain_execute(self, data: TextIO) -> None:
         """Execute the parsed children of the <assign> node.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+        """
+        self._id.set_value(self._expression.evaluate(data, self._line))
+
+    def instrumented_execute(self, data: TextIO) -> None:
+        """Execute the <assign> node, and call its hooks.
+
+        If a resource governor has been assigned to Prog.governor, then 
+        check the size of the value assigned. If a flight recorder has 
+        been assigned to Prog.tracer, then record the assignment.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
         """
         value = self._expression.evaluate(data, self._line)
         self._id.set_value(value)
+        if Prog.governor:
+            Prog.governor.assign(value, data, self._line)
+        if Prog.tracer:
+            Prog.tracer.assign(self._expression, self._id, value)
+
+    execute = plain_execute
+
+    def record(self, data: TextIO, trace: 'jit.Trace') -> None:
+        """Execute the parsed children of the <assign> node, and record.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
+            trace: The trace that the assignment is appended to.
+        """
+        trace.assign(self._id, self._expression)
+        self.execute(data)
+
+    def compile(self, compiler: 'jit.LoopCompiler') -> None:
+        """Translate the parsed children of the <assign> node to Python.
+
+        Args:
+            compiler: The compiler that the translated assignment is 
+                emitted to.
+        """
+        compiler.assign(self._id, self._expression)
+
+    def analyze(self, analysis: 'ranges.RangeAnalysis',
+                state: dict | None) -> dict | None:
+        """Analyze the parsed children of the <assign> node.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals before this node, or None if this 
+                node is unreachable.
+
+        Returns:
+            The state after this node.
+        """
+        if state is None:
+            return None
+        return analysis.assign(state, self._id,
+                               self._expression.bounds(analysis, state),
+                               self._line)
+
+    def specialize(self, specializer: 'specialize.Specializer') -> None:
+        """Specialize the parsed children of the <assign> node.
+
+        Args:
+            specializer: The partial evaluator that executes or emits 
+                the statements.
+        """
+        specializer.assign(self._id, self._expression, self._line)
+
+    def summarize(self, summary: 'memo.LoopSummary',
+                  assigned: frozenset['Id']) -> frozenset['Id']:
+        """Summarize the effects of the parsed children of <assign>.
+
+        Args:
+            summary: The summary of the loop that contains this node.
+            assigned: The set of Id instances assigned on every path 
+                from the entry of that loop to this node.
+
+        Returns:
+            The set of Id instances assigned on every path from the 
+            entry of that loop to the end of this node.
+        """
+        summary.use(self._expression, assigned)
+        return summary.define(self._id, assigned)
+
+    def get_expression(self) -> 'Exp':
+        """Return the <exp> node of the <assign> production."""
+        return self._expression
 
 class Exp:
     """Encapsulation of the production for the <exp> nonterminal.
@@ -1336,6 +2549,9 @@ class Exp:
             parse
             print
             evaluate
+            compile
+            bounds
+            get_line
     """
 
     def __init__(self, line_number: int) -> None:
@@ -1367,7 +2583,7 @@ class Exp:
             self._subtract_expression.parse()
 
     def print(self) -> None:
-        """Print an alternator of the <exp> production to stdout.
+        """Print an alternator of the <exp> production to the listing.
 
         Print the terminals in the parsed alternator of <exp>, calling 
         the print() method of the class instances representing the 
@@ -1376,10 +2592,10 @@ class Exp:
         """
         self._factor.print()
         if self._add_expression:
-            print(' + ', end = '')
+            Prog.listing.append(' + ')
             self._add_expression.print()
         if self._subtract_expression:
-            print(' - ', end = '')
+            Prog.listing.append(' - ')
             self._subtract_expression.print()
 
     def evaluate(self, data: TextIO, line_number: int) -> int:
@@ -1395,10 +2611,10 @@ class Exp:
         the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose parse() method resulted in the 
@@ -1419,6 +2635,58 @@ class Exp:
         else:
             return self._factor.evaluate(data, line_number)
 
+    def compile(self, names: dict['Id', str]) -> str:
+        """Translate the parsed <exp> alternator to a Python expression.
+
+        The grammar of <exp> is right-recursive, so every binary 
+        operation is parenthesized to preserve its association.
+
+        Args:
+            names: A dict whose keys are Id instances and whose values 
+                are the Python expressions that hold their values. 
+
+        Returns:
+            A Python expression that is equivalent to the evaluation of 
+            this Exp instance.
+        """
+        if self._add_expression:
+            return '({0} + {1})'.format(self._factor.compile(names),
+                                        self._add_expression.compile(names))
+        elif self._subtract_expression:
+            return '({0} - {1})'.format(
+                self._factor.compile(names),
+                self._subtract_expression.compile(names))
+        else:
+            return self._factor.compile(names)
+
+    def bounds(self, analysis: 'ranges.RangeAnalysis',
+               state: dict) -> 'ranges.Interval':
+        """Bound the evaluation of the parsed <exp> alternator.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals.
+
+        Returns:
+            The interval of the values that this Exp instance may 
+            evaluate to.
+        """
+        if self._add_expression:
+            return analysis.add(self._factor.bounds(analysis, state),
+                                self._add_expression.bounds(analysis, state))
+        elif self._subtract_expression:
+            return analysis.subtract(
+                self._factor.bounds(analysis, state),
+                self._subtract_expression.bounds(analysis, state))
+        else:
+            return self._factor.bounds(analysis, state)
+
+    def get_line(self) -> int:
+        """Return the line whereat this <exp> appears in the program."""
+        return self._line
+
 class Fac:
     """Encapsulation of the production for the <fac> nonterminal.
 
@@ -1431,6 +2699,8 @@ class Fac:
             parse
             print
             evaluate
+            compile
+            bounds
     """
 
     def __init__(self, line_number: int) -> None:
@@ -1457,7 +2727,7 @@ class Fac:
             self._factor.parse()
 
     def print(self) -> None:
-        """Print an alternator of the <fac> production to stdout.
+        """Print an alternator of the <fac> production to the listing.
 
         Print the terminals in the parsed alternator of <fac>, calling 
         the print() method of the class instances representing the 
@@ -1466,7 +2736,7 @@ class Fac:
         """
         self._operand.print()
         if self._factor:
-            print(' * ', end = '')
+            Prog.listing.append(' * ')
             self._factor.print()
 
     def evaluate(self, data: TextIO, line_number: int) -> int:
@@ -1481,10 +2751,10 @@ class Fac:
         next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose parse() method resulted in the 
@@ -1502,6 +2772,43 @@ class Fac:
         else:
             return self._operand.evaluate(data, line_number)
 
+    def compile(self, names: dict['Id', str]) -> str:
+        """Translate the parsed <fac> alternator to a Python expression.
+
+        Args:
+            names: A dict whose keys are Id instances and whose values 
+                are the Python expressions that hold their values. 
+
+        Returns:
+            A Python expression that is equivalent to the evaluation of 
+            this Fac instance.
+        """
+        if self._factor:
+            return '({0} * {1})'.format(self._operand.compile(names),
+                                        self._factor.compile(names))
+        else:
+            return self._operand.compile(names)
+
+    def bounds(self, analysis: 'ranges.RangeAnalysis',
+               state: dict) -> 'ranges.Interval':
+        """Bound the evaluation of the parsed <fac> alternator.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals.
+
+        Returns:
+            The interval of the values that this Fac instance may 
+            evaluate to.
+        """
+        if self._factor:
+            return analysis.multiply(self._operand.bounds(analysis, state),
+                                     self._factor.bounds(analysis, state))
+        else:
+            return self._operand.bounds(analysis, state)
+
 class Op:
     """Encapsulation of the production for the <op> nonterminal.
 
@@ -1514,6 +2821,9 @@ class Op:
             parse
             print
             evaluate
+            compile
+            bounds
+            get_id
     """
 
     def __init__(self, line_number: int) -> None:
@@ -1553,7 +2863,7 @@ class Op:
             context_free_error_checker()
 
     def print(self) -> None:
-        """Print an alternator of the <op> production to stdout.
+        """Print an alternator of the <op> production to the listing.
 
         Print the terminals in the parsed alternator of <op>, calling 
         the print() method of the class instances representing the 
@@ -1565,9 +2875,9 @@ class Op:
         if self._id:
             self._id.print()
         if self._parenth_exp:
-            print('( ', end = '')
+            Prog.listing.append('( ')
             self._parenth_exp.print()
-            print(' )', end = '')
+            Prog.listing.append(' )')
 
     def evaluate(self, data: TextIO, line_number: int) -> int:
         """Evaluate the child of the parsed <op> alternator.
@@ -1579,10 +2889,10 @@ class Op:
         evaluation at the next level of the APT.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose parse() method resulted in the 
@@ -1601,6 +2911,49 @@ class Op:
         if self._parenth_exp:
             return self._parenth_exp.evaluate(data, line_number)
 
+    def compile(self, names: dict['Id', str]) -> str:
+        """Translate the parsed <op> alternator to a Python expression.
+
+        Args:
+            names: A dict whose keys are Id instances and whose values 
+                are the Python expressions that hold their values. 
+
+        Returns:
+            A Python expression that is equivalent to the evaluation of 
+            this Op instance.
+        """
+        if self._int:
+            return self._int.compile()
+        if self._id:
+            return self._id.compile(names)
+        if self._parenth_exp:
+            return self._parenth_exp.compile(names)
+
+    def bounds(self, analysis: 'ranges.RangeAnalysis',
+               state: dict) -> 'ranges.Interval':
+        """Bound the evaluation of the parsed <op> alternator.
+
+        Args:
+            analysis: The range analysis that provides the transfer 
+                functions.
+            state: A dict whose keys are Id instances and whose values 
+                are their intervals.
+
+        Returns:
+            The interval of the values that this Op instance may 
+            evaluate to.
+        """
+        if self._int:
+            return self._int.bounds(analysis)
+        if self._id:
+            return self._id.bounds(analysis, state)
+        if self._parenth_exp:
+            return self._parenth_exp.bounds(analysis, state)
+
+    def get_id(self) -> 'Id | None':
+        """Return the Id child of the <op> node, if it has one."""
+        return self._id
+
 class ParenthExp:
     """Encapsulation of the third alternator of the production of <op>.
 
@@ -1610,6 +2963,8 @@ class ParenthExp:
             parse
             print
             evaluate
+            compile
+            bounds
     """
 
     def __init__(self, line_number: int) -> None:
@@ -1638,10 +2993,10 @@ class ParenthExp:
         """Evaluate the child of the parsed (<exp>) node.
 
         Args:
-            data: An instance of io.TextIOWrapper that provides 
-                high-level access to the buffered binary stream 
-                containing input data for "read" statements in the Core 
-                program.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile 
+                instance, whose next_value() method returns the next 
+                input value for a "read" statement in the Core program, 
+                and whose fail() method reports why there is none.
             line_number: The line whereat the alternator of the 
                 production of <stmt> that is encapsulated in the 
                 Statement instance whose parse() method resulted in the 
@@ -1654,6 +3009,15 @@ class ParenthExp:
         """
         return self._expression.evaluate(data, line_number)
 
+    def compile(self, names: dict['Id', str]) -> str:
+        """Translate the child of the (<exp>) node to Python."""
+        return self._expression.compile(names)
+
+    def bounds(self, analysis: 'ranges.RangeAnalysis',
+               state: dict) -> 'ranges.Interval':
+        """Bound the evaluation of the child of the (<exp>) node."""
+        return self._expression.bounds(analysis, state)
+
 class Int:
     """Encapsulation of the production for the <int> nonterminal.
 
@@ -1666,6 +3030,8 @@ class Int:
             parse
             print
             get_value
+            compile
+            bounds
     """
 
     def __init__(self, value: int) -> None:
@@ -1677,8 +3043,16 @@ class Int:
             __main__.core.enums.Token['INTEGER'].value, 'integer')
 
     def print(self) -> None:
-        """Print the value of this Int instance."""
-        print(self._value, end = '')
+        """Print the value of this Int instance to the listing."""
+        Prog.listing.append(str(self._value))
+
+    def compile(self) -> str:
+        """Return the Python literal for the value of this instance."""
+        return str(self._value)
+
+    def bounds(self, analysis: 'ranges.RangeAnalysis') -> 'ranges.Interval':
+        """Return the interval that holds only this instance's value."""
+        return analysis.constant(self._value)
 
     def get_value(self) -> int:
         """Get the value of this Int instance.
@@ -0,0 +1,154 @@
+"""This module provides the infinite-loop detector of the Core interpreter.
+
+A <loop> node that contains no "read" or "write" statement, directly or
+in a nested loop, is a deterministic function of the values of its read
+set, as summarized by the LoopSummary class of the memo module: the
+identifiers it may read before assigning them. If those values are the
+same at two headers of the loop at which its condition resolved to
+True, then the iterations between them repeat forever.
+
+An instance of the CycleDetector class, when assigned to the
+cycle_detector attribute of the Loop class of the bnf_grammar module,
+watches such loops with Brent's algorithm: the state at the header is
+compared with a saved state, which is replaced by the current state
+whenever the number of iterations since it was saved reaches a power
+of two. A cycle is thus found within a small multiple of the number of
+iterations it takes to first repeat, with constant memory. Both the
+tree-walk and the code compiled by the engines of the jit module check
+the loops they execute, each restarting the search when it takes over
+a loop. A detected cycle ends the run with a runtime error that names
+the line of the loop.
+"""
+
+import functools
+from typing import TextIO
+
+import bnf_grammar
+import memo
+
+class Brent:
+    """The state of a search for a cycle at the header of a loop.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            header
+
+        Private instance variables:
+            _detector: The CycleDetector instance that reports cycles.
+            _loop: The Loop instance being watched.
+            _reads: a list of the Id instances whose values make up the
+                state of the loop.
+            _saved: the saved state, or None.
+            _power: the number of iterations after which the saved
+                state is replaced.
+            _length: the number of iterations since the saved state was
+                saved.
+    """
+
+    def __init__(self, detector: 'CycleDetector', loop: 'bnf_grammar.Loop',
+                 reads: list['bnf_grammar.Id']) -> None:
+        self._detector = detector
+        self._loop = loop
+        self._reads = reads
+        self._saved = None
+        self._power = self._length = 1
+
+    def header(self, data: TextIO) -> None:
+        """Check the state at a header whose condition resolved to True.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+        """
+        state = tuple(identifier.save() for identifier in self._reads)
+        if state == self._saved:
+            self._detector.report(self._loop, data)
+        if self._power == self._length:
+            self._saved = state
+            self._power *= 2
+            self._length = 0
+        self._length += 1
+
+class CycleDetector:
+    """A detector of loops whose state repeats.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            get_reads
+            watch
+            emit
+            report
+
+        Private instance variables:
+            _summaries: a dict whose keys are Loop instances and whose
+                values are their memo.LoopSummary instances.
+    """
+
+    def __init__(self) -> None:
+        self._summaries = {}
+
+    def get_reads(self, loop: 'bnf_grammar.Loop'
+                  ) -> list['bnf_grammar.Id'] | None:
+        """Return the read set of a loop, or None if it is not watched."""
+        summary = self._summaries.get(loop)
+        if not summary:
+            summary = self._summaries[loop] = memo.LoopSummary(loop)
+        return summary.reads if summary.pure else None
+
+    def watch(self, loop: 'bnf_grammar.Loop') -> Brent | None:
+        """Return a new search for a cycle of a loop, if it is watched."""
+        reads = self.get_reads(loop)
+        if reads is None:
+            return None
+        return Brent(self, loop, reads)
+
+    def emit(self, loop: 'bnf_grammar.Loop', state: list[str],
+             namespace: dict, index: int) -> tuple[list[str], list[str]]:
+        """Return the Python source of a search for a cycle of a loop.
+
+        Args:
+            loop: The Loop instance being compiled.
+            state: The Python expressions that hold the values of the
+                read set of the loop.
+            namespace: The dict of the global names of the compiled
+                function, to which the reporting function is added.
+            index: A number that makes the names of the search unique
+                in the compiled function.
+
+        Returns:
+            The lines that start the search before the loop and the
+            lines that check the state at every header whose condition
+            resolved to True.
+        """
+        report = 'y_{0}'.format(index)
+        namespace[report] = functools.partial(self.report, loop)
+        saved, power, length = ('t_{0}'.format(index), 'p_{0}'.format(index),
+                                'm_{0}'.format(index))
+        start = ['{0}, {1}, {2} = None, 1, 1'.format(saved, power, length)]
+        check = ['h = ({0})'.format(''.join(expression + ', '
+                                            for expression in state)),
+                 'if h == {0}: {1}(data)'.format(saved, report),
+                 'if {0} == {1}:'.format(power, length),
+                 '    {0} = h; {1} *= 2; {2} = 0'.format(saved, power, length),
+                 '{0} += 1'.format(length)]
+        return start, check
+
+    def report(self, loop: 'bnf_grammar.Loop', data: TextIO) -> None:
+        """Terminate the Core interpreter because a loop never ends.
+
+        Args:
+            loop: The Loop instance whose state repeated.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+
+        Raises:
+            SystemExit: Print a message to stderr, and exit the Python
+                interpreter.
+        """
+        bnf_grammar.runtime_error(data, 'infinite loop', loop.get_line())
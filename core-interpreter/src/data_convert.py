@@ -0,0 +1,57 @@
+"""This script converts data files of the Core interpreter between formats.
+
+usage: data_convert.py [-h] [--to {text,binary}] input output
+
+positional arguments:
+    input       the path of the data file to convert, in either format
+
+    output      the path of the converted data file
+
+options:
+    -h, --help  show this help message, and exit
+
+    --to {text,binary}
+                the format of the converted data file: "text" holds one
+                integer per line, and "binary" holds a column of 64-bit
+                integers (default: the format that input is not in)
+"""
+
+import argparse
+
+import datafile
+
+def main() -> None:
+    """Convert a data file.
+
+    Load the input data file with the DataFile class of the datafile
+    module, which detects its format, and write its values to the
+    output data file in the other format, or in the format selected.
+    Every line of a text data file must hold an integer; otherwise, the
+    error that a "read" statement reaching the first line that does not
+    is reported.
+    """
+    parser = argparse.ArgumentParser()
+    parser.add_argument('input',
+                        help = 'the path of the data file to convert, in '
+                               'either format')
+    parser.add_argument('output',
+                        help = 'the path of the converted data file')
+    parser.add_argument('--to', choices = ['text', 'binary'],
+                        help = 'the format of the converted data file: '
+                               '"text" holds one integer per line, and '
+                               '"binary" holds a column of 64-bit integers '
+                               '(default: the format that input is not in)')
+    args = parser.parse_args()
+    data = datafile.DataFile(args.input)
+    if not data.is_valid():
+        data.fail()
+    if (args.to or ('text' if data.binary else 'binary')) == 'binary':
+        with open(args.output, 'wb') as file:
+            datafile.write_binary(data.get_values(), file)
+    else:
+        with open(args.output, 'w') as file:
+            datafile.write_text(data.get_values(), file)
+    data.close()
+
+if __name__ == '__main__':
+    main()
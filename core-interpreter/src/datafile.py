@@ -0,0 +1,226 @@
+"""This module provides the data file reader of the Core interpreter.
+
+An instance of the DataFile class stands in for the io.TextIOWrapper
+that the "execute" methods of the APT classes of the bnf_grammar module
+receive as their data stream. Instead of reading, checking, and
+converting one line per identifier in a "read" statement, it reads the
+whole data file in one call when it is opened. A "read" statement then
+only advances an iterator over the values, whose __next__ method is
+called directly so that no Python frame is entered per value read.
+
+A data file is either a text file with one integer per line, or a
+binary file, which is recognized by its first bytes:
+
+    MAGIC                 8 bytes
+    count                 unsigned 64-bit little-endian integer
+    column                count signed 64-bit little-endian integers
+    escapes               for every ESCAPE in the column, in order, an
+                          unsigned 32-bit little-endian length followed
+                          by the value in that many bytes of signed
+                          little-endian two's complement
+
+The column holds the values in the order they are read, except that a
+value that does not fit in 64 bits, or is ESCAPE itself, is replaced by
+ESCAPE and stored in the escapes instead. The column of a binary file
+is not converted: it is cast to a memoryview of 64-bit integers in
+place, unless it has escapes or the host is big-endian.
+
+Every line of a text file is converted to an int in a single pass, in
+which lines too long for int() are converted by the digits module. A
+text file may contain lines that are never read, so an empty or
+invalid line does not end the run when the file is opened. The pass
+stops at the first such line instead, and the run only ends with the
+runtime error of the bnf_grammar module that reading it line by line
+would have caused when a "read" statement reaches it. Only the values
+and the line the pass stopped at are kept, since the index of a value
+is the number of the line it was read from.
+"""
+
+import array
+import io
+import struct
+import sys
+from typing import BinaryIO, Iterable, NoReturn, TextIO
+
+import bnf_grammar
+import digits
+
+MAGIC = b'\x89COREint'
+ESCAPE = -2 ** 63
+_HEADER = struct.Struct('<8sQ')
+_LENGTH = struct.Struct('<I')
+
+class DataFile:
+    """A data file whose integers have been converted in bulk.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            fail
+            get_values
+            is_valid
+            close
+
+        Public instance variables:
+            name: The path of the data file.
+            binary: Whether the data file is in the binary format.
+            next_value: The __next__ method of the iterator over the
+                values, which raises StopIteration at the first empty
+                or invalid line or at the end of the file.
+
+        Private instance methods:
+            _load_text
+
+        Private instance variables:
+            _stop: the line at which the conversion stopped, with its
+                newline if it has one, or None at the end of the file.
+            _values: a list or memoryview of the ints that precede the
+                first empty or invalid line.
+    """
+
+    def __init__(self, name: str) -> None:
+        self.name = name
+        with open(name, 'rb') as file:
+            head = file.read(len(MAGIC))
+            self.binary = head == MAGIC
+            if self.binary:
+                self._stop = None
+                self._values = decode_binary(file.read(), name)
+            else:
+                self._load_text(head + file.read())
+        self.next_value = iter(self._values).__next__
+
+    def _load_text(self, content: bytes) -> None:
+        """Convert the lines of a text data file.
+
+        Args:
+            content: The bytes of the data file, which is read only
+                once so that pipes and FIFOs can be data files.
+        """
+        with io.TextIOWrapper(io.BytesIO(content)) as file:
+            lines = file.read().split('\n')
+        terminated = lines[-1] == ''
+        if terminated:
+            lines.pop()
+        self._stop = None
+        try:
+            self._values = list(map(int, lines))
+        except ValueError:
+            self._values = []
+            for line in lines:
+                try:
+                    self._values += [digits.from_decimal(line)]
+                except ValueError:
+                    break
+            cursor = len(self._values)
+            self._stop = lines[cursor]
+            if cursor < len(lines) - 1 or terminated:
+                self._stop += '\n'
+
+    def fail(self) -> NoReturn:
+        """Report the line at which next_value() stopped.
+
+        Raises:
+            SystemExit: Print a message to stderr that tells whether
+                the end of the data file has been reached or the line
+                is empty or does not contain an integer, and exit the
+                Python interpreter.
+        """
+        if self._stop is None:
+            bnf_grammar.runtime_error(self, 'input eof')
+        if self._stop == '\n':
+            bnf_grammar.runtime_error(self, 'input empty line')
+        bnf_grammar.runtime_error(self, 'input invalid line', self._stop)
+
+    def get_values(self) -> list[int] | memoryview:
+        """Return the values that precede the first empty or invalid line."""
+        return self._values
+
+    def is_valid(self) -> bool:
+        """Return whether every line of the data file holds an integer."""
+        return self._stop is None
+
+    def close(self) -> None:
+        """Release the values of the data file."""
+        self._values = []
+        self.next_value = iter(self._values).__next__
+
+def decode_binary(content: bytes, name: str) -> list[int] | memoryview:
+    """Cast the column of a binary data file, and resolve its escapes.
+
+    Args:
+        content: The bytes of the data file that follow MAGIC.
+        name: The path of the data file.
+
+    Returns:
+        The values of the data file, in the order they are read.
+
+    Raises:
+        SystemExit: The data file is truncated. Print a message to
+            stderr, and exit the Python interpreter.
+    """
+    size = _HEADER.size - len(MAGIC)
+    if len(content) < size:
+        _corrupt(name)
+    count = int.from_bytes(content[:size], 'little')
+    end = size + 8 * count
+    if len(content) < end:
+        _corrupt(name)
+    column = memoryview(content)[size:end].cast('q')
+    if sys.byteorder != 'little':
+        column = array.array('q', column)
+        column.byteswap()
+    escaped = [index for index, value in enumerate(column)
+               if value == ESCAPE] if ESCAPE in column else []
+    if not escaped:
+        return column
+    values = column.tolist()
+    position = end
+    for index in escaped:
+        if len(content) < position + _LENGTH.size:
+            _corrupt(name)
+        length, = _LENGTH.unpack_from(content, position)
+        position += _LENGTH.size
+        if len(content) < position + length:
+            _corrupt(name)
+        values[index] = int.from_bytes(
+            content[position:position + length], 'little', signed = True)
+        position += length
+    return values
+
+def _corrupt(name: str) -> NoReturn:
+    """Terminate the Core interpreter because a binary file is cut off."""
+    sys.exit("Error! Data file \"{0}\" is not a valid binary data "
+             "file!".format(name))
+
+def write_binary(values: Iterable[int], file: BinaryIO) -> None:
+    """Write integers to a file in the binary format.
+
+    Args:
+        values: The integers, in the order they are to be read.
+        file: The binary stream to write to.
+    """
+    column, escapes = array.array('q'), []
+    for value in values:
+        if ESCAPE < value < -ESCAPE:
+            column.append(value)
+        else:
+            column.append(ESCAPE)
+            length = value.bit_length() // 8 + 1
+            escapes += [_LENGTH.pack(length)
+                        + value.to_bytes(length, 'little', signed = True)]
+    if sys.byteorder != 'little':
+        column.byteswap()
+    file.write(_HEADER.pack(MAGIC, len(column)))
+    file.write(column.tobytes())
+    file.write(b''.join(escapes))
+
+def write_text(values: Iterable[int], file: TextIO) -> None:
+    """Write integers to a file in the text format, one per line.
+
+    Args:
+        values: The integers, in the order they are to be read.
+        file: The text stream to write to.
+    """
+    file.writelines('{0}\n'.format(digits.to_decimal(value))
+                    for value in values)
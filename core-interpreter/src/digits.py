@@ -0,0 +1,121 @@
+"""This module provides the integer conversions of the Core interpreter.
+
+CPython converts ints to and from decimal strings in time quadratic in
+the number of digits, and refuses to convert ints of more than 4300
+digits by default. The to_decimal and from_decimal functions convert
+ints of any size in subquadratic time by divide and conquer, and fall
+back to the built-in conversions for ints short enough that those are
+fast.
+
+to_decimal splits an int into its high and low halves of bits with
+shifts, which take linear time, converts both halves recursively to
+instances of decimal.Decimal, and recombines them as
+high * 2 ** bits + low in decimal arithmetic, whose multiplication of
+large operands is subquadratic. A Decimal whose exponent is zero is
+printed digit by digit in linear time.
+
+from_decimal splits a string of digits into halves, converts both
+recursively, and recombines them as high * 10 ** digits + low, where
+int multiplication is subquadratic (Karatsuba) and the powers of ten
+are computed once per call.
+
+to_base converts to hexadecimal or binary, which CPython does in linear
+time without a limit.
+"""
+
+import decimal
+
+SMALL = 10 ** 1000
+_CUTOFF_BITS = 128
+_CUTOFF_DIGITS = 1000
+
+def to_decimal(value: int) -> str:
+    """Return the decimal string of an int of any size.
+
+    Args:
+        value: The int to convert.
+
+    Returns:
+        The digits of value, preceded by '-' if it is negative, as
+        str(value) would return them without its digit limit.
+    """
+    if -SMALL < value < SMALL:
+        return str(value)
+    sign, value = ('-', -value) if value < 0 else ('', value)
+    powers = {}
+
+    def power(bits: int) -> decimal.Decimal:
+        """Return 2 ** bits as a Decimal, remembering every power."""
+        result = powers.get(bits)
+        if result is None:
+            if bits <= _CUTOFF_BITS:
+                result = decimal.Decimal(2) ** bits
+            else:
+                half = bits >> 1
+                result = power(half) * power(bits - half)
+            powers[bits] = result
+        return result
+
+    def convert(value: int, bits: int) -> decimal.Decimal:
+        """Return value, which has at most bits bits, as a Decimal."""
+        if bits <= _CUTOFF_BITS:
+            return decimal.Decimal(value)
+        half = bits >> 1
+        high = value >> half
+        low = value - (high << half)
+        return convert(high, bits - half) * power(half) + convert(low, half)
+
+    with decimal.localcontext() as context:
+        context.prec = decimal.MAX_PREC
+        context.Emax = decimal.MAX_EMAX
+        context.Emin = decimal.MIN_EMIN
+        context.traps[decimal.Inexact] = True
+        return sign + str(convert(value, value.bit_length()))
+
+def from_decimal(text: str) -> int:
+    """Return the int of a decimal string of any length.
+
+    Args:
+        text: The string to convert, which int() would accept if it
+            were short enough.
+
+    Raises:
+        ValueError: text does not hold a decimal integer. Strings too
+            long for int() must consist of ASCII digits, optionally
+            preceded by a sign and surrounded by whitespace.
+    """
+    if len(text) <= _CUTOFF_DIGITS:
+        return int(text)
+    text = text.strip()
+    sign = -1 if text[:1] == '-' else 1
+    if text[:1] in '+-':
+        text = text[1:]
+    if not (text.isascii() and text.isdigit()):
+        raise ValueError('invalid literal for from_decimal(): {0!r}'
+                         .format(text[:20]))
+    powers = {}
+
+    def power(digits: int) -> int:
+        """Return 10 ** digits, remembering every power."""
+        result = powers.get(digits)
+        if result is None:
+            result = powers[digits] = 10 ** digits
+        return result
+
+    def convert(start: int, end: int) -> int:
+        """Return the int of the digits text[start:end]."""
+        if end - start <= _CUTOFF_DIGITS:
+            return int(text[start:end])
+        middle = (start + end) >> 1
+        return convert(start, middle) * power(end - middle) + convert(middle,
+                                                                      end)
+
+    return sign * convert(0, len(text))
+
+def to_base(value: int, base: int) -> str:
+    """Return the string of an int in base 10, 16 ('0x'), or 2 ('0b')."""
+    if base == 16:
+        return hex(value)
+    if base == 2:
+        return bin(value)
+    return to_decimal(value)
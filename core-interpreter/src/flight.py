@@ -0,0 +1,364 @@
+"""This module provides the flight recorder of the Core interpreter.
+
+An instance of the FlightRecorder class keeps the most recent events of
+the execution of a Core program in a ring buffer: every assignment, with
+the identifier assigned and its value, every outcome of the condition of
+an "if" or "while" statement, and every identifier read or written by a
+"read" or "write" statement, with its value. The dump method writes them
+to a binary file of fixed-size records, oldest first, along with the
+line and pretty-printed text of every statement that they refer to, so
+that the decode function renders them without the Core program. The
+flight_decode.py script prints a dump.
+
+The ring buffer is a deque with a maximum length of the capacity, so
+that recording an event is a single append, which evicts the oldest
+event whole. An event is appended as one tuple of the number of its
+statement, the number of its identifier, its branch, and its value, or
+None for an outcome. The numbers are interned once per statement and
+outcome or identifier, and the tuple of an outcome is a constant. The
+code compiled by the engines of the jit module builds the tuple of an
+assignment in place, and the tree-walk records its events through the
+assign, branch, read, and write methods, which the APT classes of the
+bnf_grammar module call through the tracer hook of its Prog class; the
+instrument function there describes what a run without it pays. A loop
+skipped by the memo module records nothing.
+
+A dump starts with MAGIC and a HEADER of the numbers of statements,
+identifiers, and records, followed by the statements (a line number, a
+kind, and a length-prefixed text), the identifiers (a length-prefixed
+name), and the records, each of which is a RECORD of the statement
+number, the identifier number or -1, the branch (1 or 0 for a condition
+that resolved to True or False, or -1), a flag that is set if the value
+does not fit in 64 bits, and the value, or its number of bits if it does
+not fit.
+"""
+
+import collections
+import os
+import signal
+import struct
+import sys
+import types
+from typing import BinaryIO, Iterator, TextIO
+
+import bnf_grammar
+import metrics
+
+DEFAULT_CAPACITY = 65536
+
+MAGIC = b'CORETRC1'
+
+KINDS = ('assign', 'if', 'while', 'read', 'write')
+
+HEADER = struct.Struct('<III')
+
+RECORD = struct.Struct('<IibBq')
+
+_LENGTH = struct.Struct('<H')
+
+_STATEMENT = struct.Struct('<IB')
+
+class FlightRecorder:
+    """The ring buffer of the most recent events of a Core program.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            start
+            stop
+            assign
+            branch
+            read
+            write
+            emit_assign
+            emit_branch
+            records
+            dump
+            handle_signals
+
+        Private instance methods:
+            _code
+            _statement
+            _dump_on_signal
+
+        Private instance variables:
+            _events: a deque of the most recent events, each of which
+                is a tuple of the numbers of its statement, identifier,
+                and branch, and its value or None.
+            _codes: a dict whose keys are tuples of a node, an outcome
+                or None, and an Id instance or None, and whose values
+                are the tuples that represent their events.
+            _assigned: a dict whose keys are the Exp instances of the
+                assignments recorded by the tree-walk and whose values
+                are the tuples of their events.
+            _outcomes: a dict whose keys are the Cond instances recorded
+                by the tree-walk and whose values are the events that
+                they record when they resolve to False and to True.
+            _numbers: a dict whose keys are the nodes of the statements
+                that have been recorded and whose values are their
+                numbers.
+            _statements: a list of tuples of the line, kind, and text of
+                the statements that have been recorded, by number.
+            _kinds: a dict whose keys are the Cond instances of the "if"
+                and "while" statements of the program and whose values
+                are "if" or "while".
+            _ids: a dict whose keys are the declared Id instances and
+                whose values are their numbers.
+            _path: the path that a signal dumps to, or None.
+    """
+
+    def __init__(self, capacity: int = DEFAULT_CAPACITY) -> None:
+        self._events = collections.deque(maxlen = max(capacity, 1))
+        self._codes = {}
+        self._assigned = {}
+        self._outcomes = {}
+        self._numbers = {}
+        self._statements = []
+        self._kinds = {}
+        self._ids = {}
+        self._path = None
+
+    def start(self, program: 'bnf_grammar.Prog') -> None:
+        """Watch the conditions of a program before it executes.
+
+        Args:
+            program: The parsed Core program.
+        """
+        for node in metrics.walk(program):
+            if isinstance(node, bnf_grammar.If):
+                self._kinds[node.get_condition()] = 'if'
+            elif isinstance(node, bnf_grammar.Loop):
+                self._kinds[node.get_condition()] = 'while'
+        for condition in self._kinds:
+            condition.set_traced(True)
+        self._ids = {identifier: number for number, identifier
+                     in enumerate(bnf_grammar.Id.get_declared())}
+
+    def stop(self) -> None:
+        """Stop watching the conditions of the program."""
+        for condition in self._kinds:
+            condition.set_traced(False)
+
+    def _statement(self, node: object, kind: str,
+                   identifier: 'bnf_grammar.Id | None') -> int:
+        """Return the number of a statement, numbering it if it is new.
+
+        Args:
+            node: The Exp instance of an assignment, the Cond instance
+                of an "if" or "while" statement, or an In or Out
+                instance.
+            kind: One of KINDS.
+            identifier: The Id instance assigned by an assignment.
+        """
+        number = self._numbers.get(node)
+        if number is None:
+            text = bnf_grammar.render(node).strip().rstrip(';')
+            if kind == 'assign':
+                text = '{0} = {1}'.format(identifier.get_name(), text)
+            number = self._numbers[node] = len(self._statements)
+            self._statements.append((node.get_line(), kind, text))
+        return number
+
+    def _code(self, node: object, kind: str, outcome: bool | None,
+              identifier: 'bnf_grammar.Id | None') -> tuple[int, int, int]:
+        """Return the tuple that represents the events of a statement.
+
+        Args:
+            node: The node of the statement, as in _statement().
+            kind: One of KINDS.
+            outcome: The Boolean that a condition resolved to, or None.
+            identifier: The Id instance assigned, read, or written, or
+                None.
+        """
+        key = node, outcome, identifier
+        code = self._codes.get(key)
+        if code is None:
+            code = self._codes[key] = (
+                self._statement(node, kind, identifier),
+                -1 if identifier is None else self._ids[identifier],
+                -1 if outcome is None else int(outcome))
+        return code
+
+    def assign(self, expression: 'bnf_grammar.Exp',
+               identifier: 'bnf_grammar.Id', value: int) -> None:
+        """Record an assignment executed by the tree-walk.
+
+        Args:
+            expression: The <exp> node of the assignment.
+            identifier: The Id instance assigned.
+            value: The value assigned.
+        """
+        code = self._assigned.get(expression)
+        if code is None:
+            code = self._assigned[expression] = self._code(
+                expression, 'assign', None, identifier)
+        self._events.append(code + (value,))
+
+    def branch(self, condition: 'bnf_grammar.Cond', outcome: bool) -> None:
+        """Record an outcome of a condition evaluated by the tree-walk."""
+        codes = self._outcomes.get(condition)
+        if codes is None:
+            codes = self._outcomes[condition] = tuple(
+                self._code(condition, self._kinds[condition], branch, None)
+                + (None,) for branch in (False, True))
+        self._events.append(codes[outcome])
+
+    def read(self, node: 'bnf_grammar.In',
+             identifiers: list['bnf_grammar.Id']) -> None:
+        """Record the values read by a "read" statement."""
+        for identifier in identifiers:
+            self._events.append(self._code(node, 'read', None, identifier)
+                                + (identifier.save()[1],))
+
+    def write(self, node: 'bnf_grammar.Out',
+              identifiers: list['bnf_grammar.Id']) -> None:
+        """Record the values written by a "write" statement."""
+        for identifier in identifiers:
+            self._events.append(self._code(node, 'write', None, identifier)
+                                + (identifier.save()[1],))
+
+    def emit_assign(self, namespace: dict, expression: 'bnf_grammar.Exp',
+                    identifier: 'bnf_grammar.Id', target: str) -> str:
+        """Return the Python source that records a compiled assignment.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, to which the ring buffer is added.
+            expression: The <exp> node of the assignment.
+            identifier: The Id instance assigned.
+            target: The Python expression that holds the value assigned.
+        """
+        namespace['t_append'] = self._events.append
+        return 't_append(({0}, {1}, {2}, {3}))'.format(
+            *self._code(expression, 'assign', None, identifier), target)
+
+    def emit_branch(self, namespace: dict, condition: 'bnf_grammar.Cond',
+                    outcome: bool) -> str:
+        """Return the Python source that records a compiled outcome.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, to which the ring buffer is added.
+            condition: The Cond instance of an "if" or "while" statement.
+            outcome: The Boolean that condition has resolved to where
+                the source is emitted.
+        """
+        namespace['t_append'] = self._events.append
+        return 't_append({0!r})'.format(self._code(
+            condition, self._kinds[condition], outcome, None) + (None,))
+
+    def records(self) -> Iterator[tuple[int, int, int, int | None]]:
+        """Yield the events held, oldest first.
+
+        Yields:
+            Tuples of the numbers of the statement, identifier, and
+            branch of an event, and its value or None.
+        """
+        yield from list(self._events)
+
+    def dump(self, path: str) -> None:
+        """Write the events held to a file in the binary format.
+
+        Args:
+            path: The path of the file.
+        """
+        records = []
+        for statement, identifier, branch, value in self.records():
+            overflow = value is not None and not (
+                -2**63 <= value < 2**63)
+            records.append(RECORD.pack(
+                statement, identifier, branch, overflow,
+                value.bit_length() if overflow else value or 0))
+        with open(path, 'wb') as file:
+            file.write(MAGIC)
+            file.write(HEADER.pack(len(self._statements), len(self._ids),
+                                   len(records)))
+            for line, kind, text in self._statements:
+                encoded = text.encode()
+                file.write(_STATEMENT.pack(line, KINDS.index(kind)))
+                file.write(_LENGTH.pack(len(encoded)) + encoded)
+            for identifier in self._ids:
+                encoded = identifier.get_name().encode()
+                file.write(_LENGTH.pack(len(encoded)) + encoded)
+            file.write(b''.join(records))
+
+    def handle_signals(self, path: str) -> None:
+        """Dump to a file whenever the process receives SIGUSR1 or SIGTERM.
+
+        The execution continues after the dump on SIGUSR1. On SIGTERM,
+        the signal is raised again with its default action once the
+        dump is written, so the process is terminated as it would have
+        been without the recorder. Signals are only handled on
+        platforms that have them, from the main thread.
+        """
+        self._path = path
+        if hasattr(signal, 'SIGUSR1'):
+            signal.signal(signal.SIGUSR1, self._dump_on_signal)
+            signal.signal(signal.SIGTERM, self._dump_on_signal)
+
+    def _dump_on_signal(self, signum: int,
+                        frame: types.FrameType | None) -> None:
+        """Dump to the path of handle_signals(), and end on SIGTERM."""
+        self.dump(self._path)
+        if signum == signal.SIGTERM:
+            signal.signal(signal.SIGTERM, signal.SIG_DFL)
+            os.kill(os.getpid(), signal.SIGTERM)
+
+def decode(file: BinaryIO) -> tuple[list[tuple[int, str, str]], list[str],
+                                    list[tuple[int, int, int, bool, int]]]:
+    """Read a dump of a flight recorder.
+
+    Args:
+        file: The binary stream of the dump.
+
+    Returns:
+        The line, kind, and text of every statement, the name of every
+        identifier, and the records, as tuples of the statement number,
+        identifier number, branch, overflow flag, and value.
+
+    Raises:
+        ValueError: The stream does not hold a dump.
+    """
+    if file.read(len(MAGIC)) != MAGIC:
+        raise ValueError('not a flight recorder dump')
+    statements, identifiers, records = HEADER.unpack(
+        file.read(HEADER.size))
+    def text() -> str:
+        length, = _LENGTH.unpack(file.read(_LENGTH.size))
+        return file.read(length).decode()
+    table = []
+    for _ in range(statements):
+        line, kind = _STATEMENT.unpack(file.read(_STATEMENT.size))
+        table.append((line, KINDS[kind], text()))
+    names = [text() for _ in range(identifiers)]
+    body = file.read(records * RECORD.size)
+    return (table, names, [RECORD.unpack_from(body, offset * RECORD.size)
+                           for offset in range(records)])
+
+def render(file: BinaryIO, out: TextIO = sys.stdout,
+           last: int | None = None) -> None:
+    """Print the records of a dump against the statements of the program.
+
+    Every record is printed on a line with its line number in the Core
+    program, the pretty-printed text of its statement, and its event.
+
+    Args:
+        file: The binary stream of the dump.
+        out: The text stream to print to.
+        last: The number of most recent records to print, or None for
+            every record.
+    """
+    table, names, records = decode(file)
+    if last is not None:
+        records = records[max(len(records) - last, 0):]
+    for statement, identifier, branch, overflow, value in records:
+        line, kind, text = table[statement]
+        if branch >= 0:
+            event = 'true' if branch else 'false'
+        else:
+            event = '{0} = {1}'.format(
+                names[identifier],
+                'a {0}-bit integer'.format(value) if overflow else value)
+        if kind in ('if', 'while'):
+            text = '{0} {1}'.format(kind, text)
+        print('{0:>6}  {1:<40}  {2}'.format(line, text, event), file = out)
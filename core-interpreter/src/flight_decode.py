@@ -0,0 +1,42 @@
+"""This script prints a dump of the flight recorder of the Core interpreter.
+
+usage: flight_decode.py [-h] [--last N] dump
+
+positional arguments:
+    dump        the path of the file written by --flight-recorder
+
+options:
+    -h, --help  show this help message, and exit
+
+    --last N    print only the N most recent events
+"""
+
+import argparse
+import struct
+import sys
+
+import flight
+
+def main() -> None:
+    """Print the events of a dump, oldest first.
+
+    Every event is printed with the line of its statement in the Core
+    program and the pretty-printed text of the statement, followed by
+    the outcome of a condition or the identifier assigned, read, or
+    written and its value.
+    """
+    parser = argparse.ArgumentParser()
+    parser.add_argument('dump',
+                        help = 'the path of the file written by '
+                               '--flight-recorder')
+    parser.add_argument('--last', type = int, metavar = 'N',
+                        help = 'print only the N most recent events')
+    args = parser.parse_args()
+    try:
+        with open(args.dump, 'rb') as file:
+            flight.render(file, last = args.last)
+    except (OSError, ValueError, struct.error) as error:
+        sys.exit('Error! Cannot decode "{0}": {1}'.format(args.dump, error))
+
+if __name__ == '__main__':
+    main()
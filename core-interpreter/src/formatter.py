@@ -0,0 +1,159 @@
+"""This module provides the streaming formatter of the Core interpreter.
+
+An instance of the StreamingFormatter class prints the canonical
+pretty-printed form of a Core program, which the "print" methods of the
+bnf_grammar module produce from the APT, directly from the token stream
+of an instance of the Tokenizer class of the core module. No APT is
+built: every token is laid out as soon as the tokenizer returns it, by
+a small state machine that tracks the indentation levels of the
+enclosing "if" and "while" statements, so the memory used depends only
+on the longest line and the deepest nesting of the program, not on its
+size. The formatted text is buffered and written in blocks of at least
+DEFAULT_THRESHOLD characters of the output module.
+
+The layout is that of the print methods:
+    - every declaration and statement starts a line, indented by the
+      level of its statement sequence;
+    - "then" ends the line of its "if", and "loop" gets a line of its
+      own, one level deeper than its "while";
+    - the statements of an "if" are one level deeper than it, and those
+      of a "while" two levels deeper;
+    - "else" and "end" are at the level of their statement;
+    - binary operators and "=" are surrounded by spaces, brackets and
+      parentheses are padded on the inside, and commas are followed by
+      a space;
+    - integers are printed without leading zeros.
+
+The formatter checks the tokens of the program, but not its grammar:
+the layout of a program that does not parse is unspecified. The
+bnf_grammar module stays the reference implementation of the layout.
+"""
+
+import sys
+from typing import TextIO
+
+import bnf_grammar
+import core
+import enums
+import output
+
+_INDENT = bnf_grammar.Prog.pretty_print_indent
+_LAYOUT = {enums.Token[name].value: text
+           for name, text in {**core.RESERVED, **core.SPECIAL}.items()}
+_LAYOUT.update({token.value: ' {0} '.format(_LAYOUT[token.value])
+                for token in (enums.Token.ASSIGNMENT,
+                              enums.Token.LOGICAL_AND, enums.Token.LOGICAL_OR,
+                              enums.Token.ADDITION, enums.Token.SUBTRACTION,
+                              enums.Token.MULTIPLICATION,
+                              enums.Token.NOT_EQUAL, enums.Token.EQUAL,
+                              enums.Token.LESS_THAN, enums.Token.GREATER_THAN,
+                              enums.Token.LESS_THAN_OR_EQUAL,
+                              enums.Token.GREATER_THAN_OR_EQUAL)})
+_LAYOUT.update({
+    enums.Token.PROGRAM.value: 'program\n',
+    enums.Token.BEGIN.value: 'begin\n',
+    enums.Token.INT.value: 'int ',
+    enums.Token.IF.value: 'if ',
+    enums.Token.WHILE.value: 'while ',
+    enums.Token.READ.value: 'read ',
+    enums.Token.WRITE.value: 'write ',
+    enums.Token.SEMICOLON.value: ';\n',
+    enums.Token.COMMA.value: ', ',
+    enums.Token.LEFT_BRACKET.value: '[ ',
+    enums.Token.RIGHT_BRACKET.value: ' ]',
+    enums.Token.LEFT_PARENTHESIS.value: '( ',
+    enums.Token.RIGHT_PARENTHESIS.value: ' )'
+})
+_INDENTED = frozenset(token.value for token in (enums.Token.INT,
+                                                 enums.Token.IF,
+                                                 enums.Token.WHILE,
+                                                 enums.Token.READ,
+                                                 enums.Token.WRITE,
+                                                 enums.Token.IDENTIFIER))
+
+class StreamingFormatter:
+    """A pretty-printer driven by the token stream of a Core program.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            format
+
+        Private instance methods:
+            _emit
+            _flush
+
+        Private instance variables:
+            _tokenizer: The Tokenizer instance of the Core program,
+                whose current token is the first of the program.
+            _file: The text stream that the program is printed to.
+            _threshold: The number of buffered characters at which the
+                buffer is written to the stream.
+            _parts: a list of the buffered strings.
+            _size: the number of buffered characters.
+    """
+
+    def __init__(self, tokenizer: core.Tokenizer, file: TextIO = sys.stdout,
+                 threshold: int = output.DEFAULT_THRESHOLD) -> None:
+        self._tokenizer = tokenizer
+        self._file = file
+        self._threshold = threshold
+        self._parts = []
+        self._size = 0
+
+    def format(self) -> None:
+        """Print the program, one token at a time, until its end.
+
+        Raises:
+            SystemExit: The program contains an illegal token. Print a
+                message to stderr, and exit the Python interpreter; the
+                part of the program before the token may have been
+                printed.
+        """
+        tokenizer = self._tokenizer
+        levels, level, line_start = [], 1, True
+        while True:
+            token = tokenizer.get_token()
+            if token == enums.StopToken.EOF.value:
+                break
+            if token == enums.Token.INTEGER.value:
+                text = str(tokenizer.int_val())
+            elif token == enums.Token.IDENTIFIER.value:
+                text = tokenizer.id_name()
+            elif token == enums.Token.THEN.value:
+                text = ' then\n'
+                levels.append(level)
+                level += 1
+            elif token == enums.Token.LOOP.value:
+                text = '\n' + _INDENT * (level + 1) + 'loop\n'
+                levels.append(level)
+                level += 2
+            elif token == enums.Token.ELSE.value:
+                text = _INDENT * (levels[-1] if levels else 0) + 'else\n'
+            elif token == enums.Token.END.value:
+                if levels:
+                    level = levels.pop()
+                    text = _INDENT * level + 'end'
+                else:
+                    text = 'end\n'
+            else:
+                text = _LAYOUT[token]
+            if line_start and token in _INDENTED:
+                text = _INDENT * level + text
+            self._emit(text)
+            line_start = text[-1] == '\n'
+            tokenizer.skip_token()
+        self._flush()
+
+    def _emit(self, text: str) -> None:
+        """Buffer text, and write the buffer once it is large enough."""
+        self._parts.append(text)
+        self._size += len(text)
+        if self._size >= self._threshold:
+            self._flush()
+
+    def _flush(self) -> None:
+        """Write the buffer to the stream."""
+        self._file.write(''.join(self._parts))
+        self._parts, self._size = [], 0
+        self._file.flush()
@@ -0,0 +1,287 @@
+"""This module provides the resource governor of the Core interpreter.
+
+An instance of the ResourceGovernor class bounds the execution of a
+Core program when it is passed to the "execute" method of the Prog
+class of the bnf_grammar module. It limits the number of loop
+iterations, the wall-clock time of the run, the number of bits of the
+integers the identifiers hold, and the number of characters the
+"write" statements print.
+
+The output is counted exactly as it is printed, and the integer size
+limit is checked on every assignment, in the tree-walk and in the code
+compiled by the engines of the jit module, so that an integer can grow
+past it by one multiplication at most. The other limits are checked on
+loop back-edges, the only places where a Core program can run for long:
+every back-edge decrements a countdown, and the limits are only checked
+when it reaches zero. The countdown never runs past the step limit,
+which is therefore exact. With a time or integer size limit, the
+countdown starts from 1 and doubles at every check up to
+CHECK_INTERVAL, but drops back to 1 whenever a check finds that the
+largest integer held by an identifier has more than doubled its bits,
+so that a loop whose iterations grow slower with its integers is checked
+at every iteration. An exceeded limit ends the run through the
+runtime_error function of the bnf_grammar module, which exits with the
+exit status RESOURCE_LIMIT_EXIT_CODE of that module instead of 1.
+"""
+
+import time
+from typing import Iterable, TextIO
+
+import bnf_grammar
+import memo
+
+CHECK_INTERVAL = 1024
+
+class ResourceGovernor:
+    """The limits on the resources of a run and their consumption.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            start
+            back_edge
+            get_steps
+            charge
+            check
+            assign
+            output
+            get_writes
+            emit
+            emit_assign
+
+        Private instance methods:
+            _rewind
+            _exceed_bits
+
+        Public instance variables:
+            countdown: The number of back-edges left until the next
+                check.
+
+        Private instance variables:
+            _max_steps: The number of loop iterations allowed, or None.
+            _max_seconds: The number of seconds of wall-clock time
+                allowed, or None.
+            _max_bits: The number of bits allowed in the absolute value
+                of an integer, or None.
+            _max_output: The number of characters of output allowed, or
+                None.
+            _steps: the number of back-edges counted by past checks.
+            _interval: the number of back-edges the countdown started
+                from.
+            _next: the number of back-edges the next countdown starts
+                from, unless the step limit is closer.
+            _bits: the number of bits of the largest integer found by
+                the last check.
+            _deadline: the time.monotonic() value at which the run
+                exceeds its time limit, or None.
+            _output: the number of characters printed.
+            _writes: a dict whose keys are Loop instances and whose
+                values are the lists of Id instances they assign.
+    """
+
+    def __init__(self, max_steps: int | None = None,
+                 max_seconds: float | None = None,
+                 max_bits: int | None = None,
+                 max_output: int | None = None) -> None:
+        self._max_steps = max_steps
+        self._max_seconds = max_seconds
+        self._max_bits = max_bits
+        self._max_output = max_output
+        self._steps = 0
+        self._next = CHECK_INTERVAL
+        if max_seconds is not None or max_bits is not None:
+            self._next = 1
+        self._bits = 0
+        self._deadline = None
+        self._output = 0
+        self._writes = {}
+        self._rewind()
+
+    def _rewind(self) -> None:
+        """Restart the countdown, stopping it at the step limit."""
+        self._interval = self._next
+        if self._max_steps is not None:
+            self._interval = max(1, min(self._next,
+                                        self._max_steps - self._steps + 1))
+        self.countdown = self._interval
+
+    def start(self) -> None:
+        """Start the wall clock of the run."""
+        if self._max_seconds is not None:
+            self._deadline = time.monotonic() + self._max_seconds
+
+    def back_edge(self, data: TextIO, line: int) -> None:
+        """Count a back-edge in the tree-walk, checking if it is due.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+            line: The line whereat the loop appears in the Core program.
+        """
+        self.countdown -= 1
+        if self.countdown <= 0:
+            self.check(data, line)
+
+    def get_steps(self) -> int:
+        """Return the number of back-edges counted so far."""
+        return self._steps + self._interval - self.countdown
+
+    def charge(self, steps: int, data: TextIO, line: int) -> bool:
+        """Count the back-edges of a loop that was not executed.
+
+        Args:
+            steps: The number of back-edges to count.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+            line: The line whereat the loop appears in the Core program.
+
+        Returns:
+            False, without counting them, if the back-edges would
+            exceed the step limit, so that the loop has to be executed
+            to end the run where the tree-walk would; True otherwise.
+        """
+        if (self._max_steps is not None
+                and self.get_steps() + steps > self._max_steps):
+            return False
+        self.countdown -= steps
+        if self.countdown <= 0:
+            self.check(data, line)
+        return True
+
+    def check(self, data: TextIO, line: int, values: Iterable = ()) -> None:
+        """Check every limit, and restart the countdown.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+            line: The line whereat the loop that checks appears in the
+                Core program.
+            values: The values of identifiers that compiled code holds
+                in Python locals, which are checked along with the
+                values of the Id instances.
+
+        Raises:
+            SystemExit: A limit was exceeded. Print a message to
+                stderr, and exit the Python interpreter.
+        """
+        self._steps += self._interval - self.countdown
+        self._rewind()
+        if self._max_steps is not None and self._steps > self._max_steps:
+            bnf_grammar.runtime_error(
+                data, 'resource limit', line,
+                'step limit of {0} loop iterations'.format(self._max_steps))
+        if self._deadline is not None and time.monotonic() > self._deadline:
+            bnf_grammar.runtime_error(
+                data, 'resource limit', line,
+                'time limit of {0} seconds'.format(self._max_seconds))
+        if self._max_seconds is None and self._max_bits is None:
+            return
+        bits = max((value.bit_length() for value
+                    in [identifier.save()[1] for identifier
+                        in bnf_grammar.Id.get_declared()] + list(values)
+                    if value is not None), default = 0)
+        if self._max_bits is not None and bits > self._max_bits:
+            self._exceed_bits(data, line)
+        if bits > max(2 * self._bits, 64):
+            self._next = 1
+        else:
+            self._next = min(2 * self._next, CHECK_INTERVAL)
+        self._bits = bits
+
+    def assign(self, value: int, data: TextIO, line: int) -> None:
+        """Check the size of an integer assigned by the tree-walk.
+
+        Args:
+            value: The integer assigned.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+            line: The line whereat the assignment appears in the Core
+                program.
+        """
+        if self._max_bits is not None and value.bit_length() > self._max_bits:
+            self._exceed_bits(data, line)
+
+    def _exceed_bits(self, data: TextIO, line: int) -> None:
+        """End the run for exceeding the integer size limit."""
+        bnf_grammar.runtime_error(
+            data, 'resource limit', line,
+            'integer size limit of {0} bits'.format(self._max_bits))
+
+    def output(self, size: int, data: TextIO, line: int) -> None:
+        """Count characters printed by a "write" statement.
+
+        Args:
+            size: The number of characters printed.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+            line: The line whereat the "write" statement appears in the
+                Core program.
+        """
+        self._output += size
+        if self._max_output is not None and self._output > self._max_output:
+            bnf_grammar.runtime_error(
+                data, 'resource limit', line,
+                'output limit of {0} characters'.format(self._max_output))
+
+    def get_writes(self, loop: 'bnf_grammar.Loop') -> list['bnf_grammar.Id']:
+        """Return the write set of a loop."""
+        writes = self._writes.get(loop)
+        if writes is None:
+            writes = self._writes[loop] = memo.LoopSummary(loop).writes
+        return writes
+
+    def emit(self, loop: 'bnf_grammar.Loop', values: list[str],
+             namespace: dict, index: int) -> list[str]:
+        """Return the Python source that counts a back-edge of a loop.
+
+        Args:
+            loop: The Loop instance being compiled.
+            values: The Python expressions that hold the values of the
+                write set of the loop, which the compiled code may not
+                have stored to their Id instances when it checks.
+            namespace: The dict of the global names of the compiled
+                function, to which this instance is added.
+            index: A number that makes the names of the check unique
+                in the compiled function.
+
+        Returns:
+            The lines to run at every header whose condition resolved
+            to True.
+        """
+        governor = 'g_{0}'.format(index)
+        namespace[governor] = self
+        return ['{0}.countdown -= 1'.format(governor),
+                'if {0}.countdown <= 0: {0}.check(data, {1}, ({2}))'.format(
+                    governor, loop.get_line(),
+                    ''.join(value + ', ' for value in values))]
+
+    def emit_assign(self, namespace: dict, line: int,
+                    target: str) -> list[str]:
+        """Return the Python source that checks a compiled assignment.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, to which this instance is added.
+            line: The line whereat the assignment appears in the Core
+                program.
+            target: The Python expression that holds the value assigned.
+
+        Returns:
+            No lines without an integer size limit, or else the line
+            that checks the value.
+        """
+        if self._max_bits is None:
+            return []
+        namespace['g_a'] = self
+        return ['if {0}.bit_length() > {1}: g_a.assign({0}, data, {2})'
+                .format(target, self._max_bits, line)]
@@ -1,47 +1,677 @@
 """This script provides the entry point to the Core interpreter.
 
-usage: interpret.py [-h] program data
+usage: interpret.py [-h] [--engine {tree,trace,tiered}]
+                    [--jit-threshold N] [--int64] [--loop-cache N]
+                    [--detect-cycles] [--ranges]
+                    [--data-range LO:HI] [--specialize] [--budget N]
+                    [--max-steps N] [--max-seconds S] [--max-bits N]
+                    [--max-output N] [--output-format {text,jsonl,null}]
+                    [--output-file PATH] [--output-base {10,16,2}]
+                    [--line-buffered] [--prefetch] [--data-fd FD]
+                    [--no-listing | --listing-file PATH] [--format-only]
+                    [--metrics PATH] [--metrics-format {json,prometheus}]
+                    [--profile] [--profile-interval N]
+                    [--flame PATH] [--flame-interval MS]
+                    [--coverage PATH]
+                    [--flight-recorder PATH] [--flight-records N]
+                    [--memory] [--stats] program [data]
 
 positional arguments:
     program     the path of the file containing the Core program to be
                 interpreted
 
-    data        the path of the file containing data for "read" 
-                instructions in the Core program
+    data        the path of the file containing data for "read"
+                instructions in the Core program, or "-" to read them
+                from stdin as they arrive (optional with --specialize,
+                --data-fd, or --format-only)
 
 options:
     -h, --help  show this help message, and exit
+
+    --engine {tree,trace,tiered}
+                the engine that executes the Core program: "tree"
+                walks the abstract parse tree, "trace" also traces hot
+                loops and compiles their traces to Python code, and
+                "tiered" compiles hot loops whole (default: tree)
+
+    --jit-threshold N
+                the number of iterations after which a loop is traced
+                or compiled (default: 100)
+
+    --int64     check that the identifiers assigned by compiled loops
+                fit in 64-bit integers whenever they are stored, and
+                move identifiers that overflow to unbounded integers
+                (requires --engine tiered)
+
+    --loop-cache N
+                memoize every loop free of "read" and "write"
+                statements by the values of the identifiers it reads,
+                keeping the exit values of the N most recently used
+                entry values per loop (default: 0, disabled)
+
+    --detect-cycles
+                end the run with a runtime error when the identifiers
+                of a loop free of "read" and "write" statements repeat
+                their values at its header, so that the loop would
+                never terminate
+
+    --ranges    print the value range of every identifier, computed by
+                static analysis of the Core program, to stderr
+
+    --data-range LO:HI
+                declare that every value in the data file lies between
+                LO and HI inclusive, which bounds the value ranges of
+                identifiers that are read (default: unbounded)
+
+    --specialize
+                instead of executing the Core program, partially
+                evaluate it against the data file and print its output
+                if it folds completely, or else a residual Core program
+
+    --budget N  the number of steps after which --specialize stops
+                unrolling loops (default: 1000000)
+
+    --max-steps N
+                end the run with a runtime error after N loop
+                iterations
+
+    --max-seconds S
+                end the run with a runtime error after S seconds of
+                wall-clock time, checked every few loop iterations
+
+    --max-bits N
+                end the run with a runtime error once an identifier
+                is assigned an integer of more than N bits
+
+    --max-output N
+                end the run with a runtime error before the output of
+                "write" statements exceeds N characters
+
+                A run ended by any of the four limits above exits with
+                status 3.
+
+    --output-format {text,jsonl,null}
+                the format of the values written by "write" statements:
+                "text" prints "NAME = VALUE" lines after a header,
+                "jsonl" prints one JSON object per value, and "null"
+                discards them (default: text)
+
+    --output-file PATH
+                write the values to PATH instead of stdout
+
+    --output-base {10,16,2}
+                the base that values are written in; hexadecimal and
+                binary values are prefixed with "0x" and "0b", and are
+                much faster to print for huge values (default: 10)
+
+    --line-buffered
+                write every value to the output as soon as it is
+                written, for consumers that read the output as a
+                stream
+
+    --prefetch  read and convert the data file on a background thread,
+                a bounded number of lines ahead of the "read"
+                statements, instead of whole before execution; suits
+                slow storage, pipes, and FIFOs
+
+    --data-fd FD
+                read the data for "read" instructions from the open
+                file descriptor FD as they arrive, instead of from a
+                data file
+
+    --no-listing
+                do not print the Core program before executing it
+
+    --listing-file PATH
+                print the Core program to PATH instead of stdout
+
+    --format-only
+                only print the Core program, laid out from its token
+                stream as the listing is, without parsing or executing
+                it, in memory independent of its size
+
+    --metrics PATH
+                write the wall-clock and CPU time of every phase, the
+                counts of tokens, nodes, statements executed, values
+                read and written, and the peak resident set size to
+                PATH
+
+    --metrics-format {json,prometheus}
+                the format of --metrics: a JSON object or the
+                Prometheus text format (default: json)
+
+    --profile   print the number of statements executed and loop
+                iterations of every line of the Core program, and the
+                time spent in its statements, excluding the statements
+                nested in them, estimated from a sample, with the source
+                of the line, to stderr after execution, the most
+                time-consuming lines first
+
+    --profile-interval N
+                the mean number of stretches of execution between the
+                start or end of a statement and the next per stretch
+                timed by --profile (default: 16)
+
+    --flame PATH
+                sample the Core execution stack, the enclosing "while"
+                and "if" statements and the statement executed, at
+                regular intervals of CPU time, and write the number of
+                samples of every stack to PATH in the collapsed format
+                of flame graph tools
+
+    --flame-interval MS
+                the number of milliseconds between two samples of
+                --flame (default: 1)
+
+    --coverage PATH
+                write the lines of the Core program whose statements
+                were executed, and the outcomes that the conditions of
+                its "if" and "while" statements resolved to, to PATH as
+                an lcov tracefile
+
+    --flight-recorder PATH
+                keep the most recent assignments, outcomes of
+                conditions, and values read and written in a ring
+                buffer, and write it to PATH in a binary format if the
+                run ends with an error or on SIGUSR1 or SIGTERM;
+                flight_decode.py prints it
+
+    --flight-records N
+                the number of events that --flight-recorder keeps
+                (default: 65536)
+
+    --memory    trace the memory allocated, and print the blocks and
+                bytes that every phase and the statements of every line
+                of the Core program left allocated and the peak they
+                reached, and the number of nodes and bytes of every
+                class of the abstract parse tree and its depth, to
+                stderr after execution
+
+    --stats     print the statistics of the engine to stderr after
+                execution
 """
 
 import argparse
+import contextlib
+import sys
 
 import bnf_grammar
 import core
+import datafile
+import output
+
+def data_range(argument: str) -> 'ranges.Interval':
+    """Convert a LO:HI command line argument to an interval."""
+    import ranges
+    try:
+        low, high = (int(bound) for bound in argument.split(':'))
+    except ValueError:
+        raise argparse.ArgumentTypeError(
+            'expected LO:HI, got {0!r}'.format(argument))
+    if low > high:
+        raise argparse.ArgumentTypeError('LO is greater than HI')
+    return ranges.Interval(low, high)
+
+def open_data(args: argparse.Namespace
+              ) -> 'datafile.DataFile | prefetch.PrefetchingDataFile | None':
+    """Open the data file named by the command line arguments, if any.
+
+    stdin ("-") and file descriptors are read by a prefetching data
+    file, so that "read" statements consume them as they arrive, in
+    bounded memory. stdin is read from file descriptor 0 unbuffered,
+    like any other descriptor, since the thread of the data file may
+    still be reading it when the Python interpreter exits, which a
+    buffered sys.stdin does not allow.
+    """
+    if args.data_fd is not None or args.data == '-' or args.prefetch:
+        import prefetch
+    if args.data_fd is not None:
+        return prefetch.PrefetchingDataFile(
+            '<fd {0}>'.format(args.data_fd),
+            open(args.data_fd, 'rb', buffering = 0, closefd = False))
+    if args.data == '-':
+        return prefetch.PrefetchingDataFile(
+            '<stdin>', open(0, 'rb', buffering = 0, closefd = False))
+    if not args.data:
+        return None
+    if args.prefetch:
+        return prefetch.PrefetchingDataFile(args.data)
+    return datafile.DataFile(args.data)
+
+def run_specializer(program: bnf_grammar.Prog,
+                    args: argparse.Namespace) -> None:
+    """Partially evaluate a parsed Core program, and print the result.
+
+    Print the output of the program in the format of its execution if
+    it folds completely, and otherwise a residual Core program that has
+    the same output.
+
+    Args:
+        program: The parsed Core program.
+        args: The parsed command line arguments.
+
+    Raises:
+        SystemExit: The program folds to a runtime error. Print its 
+            message to stderr, and exit the Python interpreter.
+    """
+    import specialize
+    data = open_data(args)
+    budget = specialize.DEFAULT_BUDGET if args.budget is None else args.budget
+    specializer = specialize.Specializer(data, budget)
+    specializer.specialize(program)
+    if data:
+        data.close()
+    if specializer.is_folded():
+        if specializer.has_output():
+            print('\n----------Program Output----------')
+        if specializer.get_outputs():
+            print('\n'.join(specializer.get_outputs()))
+    else:
+        print('\n----------Residual Program----------')
+        print(specializer.get_residual(), end = '')
+    if args.stats:
+        sys.stdout.flush()
+        specializer.dump_stats(sys.stderr)
+    if specializer.is_folded() and specializer.get_error():
+        sys.exit(specializer.get_error())
+
+def phase(recorder: 'metrics.Metrics | None',
+          usage: 'memory.MemoryReport | None',
+          name: str) -> contextlib.ExitStack:
+    """Return the context of a phase of the Core interpreter.
+
+    Args:
+        recorder: The metrics that time the phase, or None.
+        usage: The memory report that accounts for the allocations of
+            the phase, or None.
+        name: The name of the phase.
+    """
+    stack = contextlib.ExitStack()
+    if recorder:
+        stack.enter_context(recorder.phase(name))
+    if usage:
+        stack.enter_context(usage.phase(name))
+    return stack
 
 def main() -> None:
     """Interpret a Core program.
 
-    Retrieve the paths of a Core file and data file from command line 
-    arguments passed to this script; instantiate the Tokenizer class of 
-    the core module; and tokenize, parse, print, and execute the Core 
-    program.
+    Retrieve the paths of a Core file and data file from command line
+    arguments passed to this script; instantiate the Tokenizer class of
+    the core module; and tokenize, parse, print unless the listing is
+    disabled, and execute the Core program with the selected engine,
+    analyzing its value ranges first when they are to be reported or
+    the int64 mode needs them. In the format-only mode, only lay the
+    program out from its token stream instead. If metrics are enabled,
+    write them once the run ends, even if it ends with an error, and
+    likewise report the profile of the lines of the program and the
+    memory allocated, and write the sampled stacks and the coverage.
+    Write the events held by the flight recorder only if the run ends
+    with an error.
     """
     parser = argparse.ArgumentParser()
-    parser.add_argument('program', 
+    parser.add_argument('program',
                         help = 'the path of the file containing the Core '
                                'program to be interpreted')
-    parser.add_argument('data', 
+    parser.add_argument('data', nargs = '?',
                         help = 'the path of the file containing data for '
-                               '"read" instructions in the Core program')
+                               '"read" instructions in the Core program, or '
+                               '"-" to read them from stdin as they arrive '
+                               '(optional with --specialize, --data-fd, or '
+                               '--format-only)')
+    parser.add_argument('--engine', choices = ['tree', 'trace', 'tiered'],
+                        default = 'tree',
+                        help = 'the engine that executes the Core program: '
+                               '"tree" walks the abstract parse tree, "trace" '
+                               'also traces hot loops and compiles their '
+                               'traces to Python code, and "tiered" compiles '
+                               'hot loops whole (default: tree)')
+    parser.add_argument('--jit-threshold', type = int, default = 100,
+                        metavar = 'N',
+                        help = 'the number of iterations after which a loop '
+                               'is traced or compiled (default: 100)')
+    parser.add_argument('--int64', action = 'store_true',
+                        help = 'check that the identifiers assigned by '
+                               'compiled loops fit in 64-bit integers whenever '
+                               'they are stored, and move identifiers that '
+                               'overflow to unbounded integers (requires '
+                               '--engine tiered)')
+    parser.add_argument('--loop-cache', type = int, default = 0,
+                        metavar = 'N',
+                        help = 'memoize every loop free of "read" and '
+                               '"write" statements by the values of the '
+                               'identifiers it reads, keeping the exit values '
+                               'of the N most recently used entry values per '
+                               'loop (default: 0, disabled)')
+    parser.add_argument('--detect-cycles', action = 'store_true',
+                        help = 'end the run with a runtime error when the '
+                               'identifiers of a loop free of "read" and '
+                               '"write" statements repeat their values at its '
+                               'header, so that the loop would never '
+                               'terminate')
+    parser.add_argument('--ranges', action = 'store_true',
+                        help = 'print the value range of every identifier, '
+                               'computed by static analysis of the Core '
+                               'program, to stderr')
+    parser.add_argument('--data-range', type = data_range, metavar = 'LO:HI',
+                        help = 'declare that every value in the data file '
+                               'lies between LO and HI inclusive, which '
+                               'bounds the value ranges of identifiers that '
+                               'are read (default: unbounded)')
+    parser.add_argument('--specialize', action = 'store_true',
+                        help = 'instead of executing the Core program, '
+                               'partially evaluate it against the data file '
+                               'and print its output if it folds completely, '
+                               'or else a residual Core program')
+    parser.add_argument('--budget', type = int, metavar = 'N',
+                        help = 'the number of steps after which --specialize '
+                               'stops unrolling loops (default: 1000000)')
+    parser.add_argument('--max-steps', type = int, metavar = 'N',
+                        help = 'end the run with a runtime error after N '
+                               'loop iterations')
+    parser.add_argument('--max-seconds', type = float, metavar = 'S',
+                        help = 'end the run with a runtime error after S '
+                               'seconds of wall-clock time, checked every few '
+                               'loop iterations')
+    parser.add_argument('--max-bits', type = int, metavar = 'N',
+                        help = 'end the run with a runtime error once an '
+                               'identifier is assigned an integer of more '
+                               'than N bits')
+    parser.add_argument('--max-output', type = int, metavar = 'N',
+                        help = 'end the run with a runtime error before the '
+                               'output of "write" statements exceeds N '
+                               'characters')
+    parser.add_argument('--output-format', choices = ['text', 'jsonl', 'null'],
+                        default = 'text',
+                        help = 'the format of the values written by "write" '
+                               'statements: "text" prints "NAME = VALUE" '
+                               'lines after a header, "jsonl" prints one JSON '
+                               'object per value, and "null" discards them '
+                               '(default: text)')
+    parser.add_argument('--output-file', metavar = 'PATH',
+                        help = 'write the values to PATH instead of stdout')
+    parser.add_argument('--output-base', type = int, choices = [10, 16, 2],
+                        default = 10,
+                        help = 'the base that values are written in; '
+                               'hexadecimal and binary values are prefixed '
+                               'with "0x" and "0b", and are much faster to '
+                               'print for huge values (default: 10)')
+    parser.add_argument('--line-buffered', action = 'store_true',
+                        help = 'write every value to the output as soon as '
+                               'it is written, for consumers that read the '
+                               'output as a stream')
+    parser.add_argument('--prefetch', action = 'store_true',
+                        help = 'read and convert the data file on a '
+                               'background thread, a bounded number of lines '
+                               'ahead of the "read" statements, instead of '
+                               'whole before execution; suits slow storage, '
+                               'pipes, and FIFOs')
+    parser.add_argument('--data-fd', type = int, metavar = 'FD',
+                        help = 'read the data for "read" instructions from '
+                               'the open file descriptor FD as they arrive, '
+                               'instead of from a data file')
+    listing = parser.add_mutually_exclusive_group()
+    listing.add_argument('--no-listing', action = 'store_true',
+                         help = 'do not print the Core program before '
+                                'executing it')
+    listing.add_argument('--listing-file', metavar = 'PATH',
+                         help = 'print the Core program to PATH instead of '
+                                'stdout')
+    parser.add_argument('--format-only', action = 'store_true',
+                        help = 'only print the Core program, laid out from '
+                               'its token stream as the listing is, without '
+                               'parsing or executing it, in memory '
+                               'independent of its size')
+    parser.add_argument('--metrics', metavar = 'PATH',
+                        help = 'write the wall-clock and CPU time of every '
+                               'phase, the counts of tokens, nodes, '
+                               'statements executed, values read and '
+                               'written, and the peak resident set size to '
+                               'PATH')
+    parser.add_argument('--metrics-format', choices = ['json', 'prometheus'],
+                        default = 'json',
+                        help = 'the format of --metrics: a JSON object or '
+                               'the Prometheus text format (default: json)')
+    parser.add_argument('--profile', action = 'store_true',
+                        help = 'print the number of statements executed and '
+                               'loop iterations of every line of the Core '
+                               'program, and the time spent in its '
+                               'statements, excluding the statements nested '
+                               'in them, estimated from a sample, with the '
+                               'source of the line, to stderr after '
+                               'execution, the most time-consuming lines '
+                               'first')
+    parser.add_argument('--profile-interval', type = int, metavar = 'N',
+                        help = 'the mean number of stretches of execution '
+                               'between the start or end of a statement and '
+                               'the next per stretch timed by --profile '
+                               '(default: 16)')
+    parser.add_argument('--flame', metavar = 'PATH',
+                        help = 'sample the Core execution stack, the '
+                               'enclosing "while" and "if" statements and the '
+                               'statement executed, at regular intervals of '
+                               'CPU time, and write the number of samples of '
+                               'every stack to PATH in the collapsed format '
+                               'of flame graph tools')
+    parser.add_argument('--flame-interval', type = float, metavar = 'MS',
+                        help = 'the number of milliseconds between two '
+                               'samples of --flame (default: 1)')
+    parser.add_argument('--coverage', metavar = 'PATH',
+                        help = 'write the lines of the Core program whose '
+                               'statements were executed, and the outcomes '
+                               'that the conditions of its "if" and "while" '
+                               'statements resolved to, to PATH as an lcov '
+                               'tracefile')
+    parser.add_argument('--flight-recorder', metavar = 'PATH',
+                        help = 'keep the most recent assignments, outcomes '
+                               'of conditions, and values read and written '
+                               'in a ring buffer, and write it to PATH in a '
+                               'binary format if the run ends with an error '
+                               'or on SIGUSR1 or SIGTERM; flight_decode.py '
+                               'prints it')
+    parser.add_argument('--flight-records', type = int, metavar = 'N',
+                        help = 'the number of events that --flight-recorder '
+                               'keeps (default: 65536)')
+    parser.add_argument('--memory', action = 'store_true',
+                        help = 'trace the memory allocated, and print the '
+                               'blocks and bytes that every phase and the '
+                               'statements of every line of the Core program '
+                               'left allocated and the peak they reached, '
+                               'and the number of nodes and bytes of every '
+                               'class of the abstract parse tree and its '
+                               'depth, to stderr after execution')
+    parser.add_argument('--stats', action = 'store_true',
+                        help = 'print the statistics of the engine to stderr '
+                               'after execution')
     args = parser.parse_args()
-    global tokenizer 
-    tokenizer = core.Tokenizer(args.program)
+    if args.int64 and args.engine != 'tiered':
+        parser.error('--int64 requires --engine tiered')
+    if args.data and args.data_fd is not None:
+        parser.error('data and --data-fd are mutually exclusive')
+    if args.format_only and args.no_listing:
+        parser.error('--format-only and --no-listing are mutually exclusive')
+    if args.profile and (args.specialize or args.format_only):
+        parser.error('--profile requires the Core program to be executed')
+    if args.flame and (args.specialize or args.format_only):
+        parser.error('--flame requires the Core program to be executed')
+    if args.coverage and (args.specialize or args.format_only):
+        parser.error('--coverage requires the Core program to be executed')
+    if args.flight_recorder and (args.specialize or args.format_only):
+        parser.error('--flight-recorder requires the Core program to be '
+                     'executed')
+    if args.memory and args.format_only:
+        parser.error('--memory requires the Core program to be parsed')
+    if args.flight_records is not None and args.flight_records <= 0:
+        parser.error('--flight-records must be positive')
+    if args.flame_interval is not None and args.flame_interval <= 0:
+        parser.error('--flame-interval must be positive')
+    if args.loop_cache < 0:
+        parser.error('--loop-cache must not be negative')
+    if any(limit is not None and limit <= 0 for limit in (
+               args.max_steps, args.max_seconds, args.max_bits,
+               args.max_output)):
+        parser.error('--max-steps, --max-seconds, --max-bits, and '
+                     '--max-output must be positive')
+    if args.jit_threshold < 1:
+        parser.error('--jit-threshold must be positive')
+    if args.profile_interval is not None and args.profile_interval <= 0:
+        parser.error('--profile-interval must be positive')
+    if (not args.data and args.data_fd is None and not args.specialize
+            and not args.format_only):
+        parser.error('the following arguments are required: data')
+    recorder = lines = sampler = coverage = tracer = usage = None
+    if args.metrics:
+        import metrics
+        recorder = metrics.Metrics()
+    if args.profile:
+        import profiler
+        lines = profiler.LineProfiler(profiler.DEFAULT_INTERVAL
+                                      if args.profile_interval is None
+                                      else args.profile_interval)
+    if args.flame:
+        import sampling
+        sampler = sampling.SamplingProfiler(sampling.DEFAULT_INTERVAL
+                                            if args.flame_interval is None
+                                            else args.flame_interval / 1000)
+    if args.coverage:
+        import lcov
+        coverage = lcov.Coverage()
+    if args.flight_recorder:
+        import flight
+        tracer = flight.FlightRecorder(flight.DEFAULT_CAPACITY
+                                       if args.flight_records is None
+                                       else args.flight_records)
+        tracer.handle_signals(args.flight_recorder)
+    if args.memory:
+        import memory
+        usage = memory.MemoryReport()
+        usage.start()
+    failed = True
+    try:
+        interpret(args, recorder, lines, sampler, coverage, tracer, usage)
+        failed = False
+    finally:
+        if tracer and failed:
+            tracer.dump(args.flight_recorder)
+        if coverage:
+            coverage.dump(args.coverage, args.program)
+        if recorder:
+            recorder.dump(args.metrics, args.metrics_format)
+        if sampler:
+            sampler.dump(args.flame)
+        if lines:
+            sys.stdout.flush()
+            with open(args.program) as file:
+                lines.report(file.read().split('\n'))
+        if usage:
+            usage.stop()
+            sys.stdout.flush()
+            with open(args.program) as file:
+                usage.report(file.read().split('\n'))
+
+def interpret(args: argparse.Namespace,
+              recorder: 'metrics.Metrics | None',
+              lines: 'profiler.LineProfiler | None',
+              sampler: 'sampling.SamplingProfiler | None',
+              coverage: 'lcov.Coverage | None',
+              tracer: 'flight.FlightRecorder | None',
+              usage: 'memory.MemoryReport | None') -> None:
+    """Run the phases of the Core interpreter selected by the arguments.
+
+    Args:
+        args: The parsed command line arguments.
+        recorder: The metrics that time the phases and count the
+            execution, or None.
+        lines: The profiler of the lines of the Core program, or None.
+        sampler: The sampling profiler of the execution, or None.
+        coverage: The coverage of the execution, or None.
+        tracer: The flight recorder of the execution, or None.
+        usage: The memory report of the run, or None.
+    """
+    global tokenizer
+    with phase(None, usage, 'tokenize'):
+        if recorder:
+            import metrics
+            tokenizer = metrics.TimedTokenizer(args.program, recorder)
+        else:
+            tokenizer = core.Tokenizer(args.program)
+    if args.format_only:
+        import formatter
+        with phase(recorder, None, 'format'):
+            if args.listing_file:
+                with open(args.listing_file, 'w') as file:
+                    formatter.StreamingFormatter(tokenizer, file).format()
+            else:
+                formatter.StreamingFormatter(tokenizer).format()
+        return
     program = bnf_grammar.Prog()
-    program.parse()
-    program.print()
-    data = open(args.data, 'r')
-    program.execute(data)
+    with phase(recorder, usage, 'parse'):
+        program.parse()
+    if recorder:
+        recorder.count_nodes(program)
+    if usage:
+        usage.census(program)
+    with phase(recorder, usage, 'print'):
+        if args.listing_file:
+            with open(args.listing_file, 'w') as file:
+                program.print(file)
+        elif not args.no_listing:
+            program.print()
+    if args.specialize:
+        with phase(recorder, usage, 'specialize'):
+            run_specializer(program, args)
+        return
+    proven = frozenset()
+    if args.ranges or args.int64:
+        import ranges
+        analysis = ranges.RangeAnalysis(args.data_range)
+        analysis.analyze(program)
+        proven = analysis.proven()
+        if args.ranges:
+            sys.stdout.flush()
+            analysis.dump_report(sys.stderr)
+    if args.detect_cycles:
+        import cycles
+        bnf_grammar.Loop.cycle_detector = cycles.CycleDetector()
+    if args.engine != 'tree':
+        import jit
+    if args.engine == 'trace':
+        bnf_grammar.Loop.engine = jit.TracingJit(args.jit_threshold)
+    if args.engine == 'tiered':
+        bnf_grammar.Loop.engine = jit.TieredEngine(args.jit_threshold,
+                                                   args.int64, proven)
+    if args.loop_cache:
+        import memo
+        bnf_grammar.Loop.engine = memo.MemoizingEngine(bnf_grammar.Loop.engine,
+                                                       args.loop_cache)
+    limits = None
+    if (args.max_steps is not None or args.max_seconds is not None
+            or args.max_bits is not None or args.max_output is not None):
+        import governor
+        limits = governor.ResourceGovernor(args.max_steps, args.max_seconds,
+                                           args.max_bits, args.max_output)
+    if args.output_format == 'null':
+        sink = output.NullOutput()
+    else:
+        stream = open(args.output_file, 'w') if args.output_file else sys.stdout
+        threshold = 0 if args.line_buffered else output.DEFAULT_THRESHOLD
+        if args.output_format == 'text':
+            sink = output.TextOutput(stream, threshold, args.output_base)
+        else:
+            sink = output.JsonLinesOutput(stream, threshold, args.output_base)
+    sampled = contextlib.nullcontext()
+    if sampler:
+        import sampling
+        sampled = sampling.sample(sampler)
+    data = open_data(args)
+    with phase(recorder, usage, 'execute'), sampled:
+        program.execute(data, limits, sink, recorder, lines, coverage,
+                        tracer, usage)
+        sink.close()
     data.close()
+    if args.stats and bnf_grammar.Loop.engine:
+        sys.stdout.flush()
+        bnf_grammar.Loop.engine.dump_stats(sys.stderr)
 
 if __name__ == '__main__':
     main()
@@ -0,0 +1,988 @@
+"""This module provides the JIT engines of the Core interpreter.
+
+Both engines take over the execution of <loop> nodes when an instance of
+their class is assigned to the engine attribute of the Loop class of the
+bnf_grammar module, and both tree-walk a loop until it becomes hot.
+
+The TracingJit class counts the back-edges of a loop. Once the count
+reaches a threshold, one iteration of the loop body is recorded into an
+instance of the Trace class by the "record" methods of the APT: the
+assignments performed, the direction taken at every <if> node, and the
+statements that remain calls into the tree-walk (nested loops, "read"
+and "write" statements). The trace is translated into the source of a
+Python function in which every <if> node is replaced by a guard on the
+direction that was recorded. The function is compiled once and
+re-entered at the loop header until the loop terminates or a guard
+fails. A failed guard completes the current iteration in the tree-walk,
+after which the trace is re-entered at the next iteration.
+
+The TieredEngine class starts every loop in tier 0, the tree-walk, and
+counts its iterations. Once the count reaches a threshold, the whole
+loop, including every branch and nested loop, is translated into a
+Python function by an instance of the LoopCompiler class, and the loop
+moves to tier 1: the function is entered on the next back-edge with the
+current values of the identifiers (on-stack replacement) and runs the
+remaining iterations. Should the compiled code reach a read of an
+identifier that had not been initialized when the loop was compiled and
+still is not, it stores its locals and resumes the tree-walk at the
+statement that performs the read, so that runtime errors are reported by
+the tree-walk.
+"""
+
+import array
+import sys
+from typing import Callable, TextIO
+
+import bnf_grammar
+
+BLACKLIST_EXITS = 32
+BLACKLIST_ITERATIONS_PER_EXIT = 4
+MAX_RECORDINGS = 3
+INT64_MIN, INT64_MAX = -2 ** 63, 2 ** 63 - 1
+_STORE, _LOAD = '@store', '@load'
+
+class _Locals(dict):
+    """A dict that names a Python local for each Id it is asked for.
+
+    The name is given by the function passed to the constructor, if
+    any. The Id instances asked for are also collected in the reads
+    attribute until it is reassigned.
+    """
+
+    def __init__(self, name: Callable[['bnf_grammar.Id'], str] | None = None
+                 ) -> None:
+        super().__init__()
+        self.reads = set()
+        self._name = name
+
+    def __getitem__(self, identifier: 'bnf_grammar.Id') -> str:
+        self.reads.add(identifier)
+        return super().__getitem__(identifier)
+
+    def __missing__(self, identifier: 'bnf_grammar.Id') -> str:
+        if self._name:
+            self[identifier] = self._name(identifier)
+        else:
+            self[identifier] = 'v_' + identifier.get_name()
+        return self[identifier]
+
+def _watch(loop: 'bnf_grammar.Loop', name: Callable[['bnf_grammar.Id'], str],
+           namespace: dict, index: int) -> tuple[list[str], list[str]]:
+    """Return the source that checks the headers of a loop, if anything does.
+
+    The source searches the loop for a cycle if a cycle detector has
+    been assigned to the cycle_detector attribute of the Loop class,
+    counts its back-edges if a resource governor has been assigned to
+    the governor attribute of the Prog class, and counts its iterations
+    if a profiler has been assigned to the profiler attribute of the
+    Prog class.
+
+    Args:
+        loop: The Loop instance being compiled.
+        name: A function that returns the Python expression that holds
+            the value of an Id instance in the compiled code.
+        namespace: The dict of the global names of the compiled
+            function.
+        index: A number that makes the names of the checks unique in
+            the compiled function.
+
+    Returns:
+        The lines to run before the loop and the lines to run at every
+        header whose condition resolved to True, both empty if nothing
+        checks the loop.
+    """
+    start, check = [], []
+    detector = bnf_grammar.Loop.cycle_detector
+    reads = detector and detector.get_reads(loop)
+    if reads:
+        start, check = detector.emit(loop, [name(identifier)
+                                            for identifier in reads],
+                                     namespace, index)
+    governor = bnf_grammar.Prog.governor
+    if governor:
+        check = check + governor.emit(loop, [name(identifier) for identifier
+                                             in governor.get_writes(loop)],
+                                      namespace, index)
+    profiler = bnf_grammar.Prog.profiler
+    if profiler:
+        check = check + [profiler.emit_header(namespace, loop.get_line())]
+    return start, check
+
+def _count(namespace: dict, node: object) -> list[str]:
+    """Return the source that counts a compiled statement, if anything does.
+
+    The source counts the statement if metrics have been assigned to the
+    metrics attribute of the Prog class, toward its line if a profiler
+    or a memory report has been assigned to the profiler or memory
+    attribute of that class, and fires the probe of the statement if a
+    coverage has been assigned to the coverage attribute of that class.
+
+    Args:
+        namespace: The dict of the global names of the compiled
+            function.
+        node: The <exp> node of an assignment, the <cond> node of an
+            "if" statement, or the Loop, In, or Out instance of the
+            statement.
+    """
+    line = node.get_line()
+    metrics = bnf_grammar.Prog.metrics
+    profiler = bnf_grammar.Prog.profiler
+    coverage = bnf_grammar.Prog.coverage
+    memory = bnf_grammar.Prog.memory
+    return (([metrics.emit(namespace)] if metrics else [])
+            + ([profiler.emit(namespace, line)] if profiler else [])
+            + ([coverage.emit(namespace, node)] if coverage else [])
+            + ([memory.emit(namespace, line)] if memory else []))
+
+def _assign(namespace: dict, expression: 'bnf_grammar.Exp',
+            identifier: 'bnf_grammar.Id', target: str) -> list[str]:
+    """Return the source that checks or records a compiled assignment.
+
+    The source checks the size of the value assigned if a resource
+    governor with an integer size limit has been assigned to the
+    governor attribute of the Prog class, and records the assignment if
+    a flight recorder has been assigned to its tracer attribute.
+
+    Args:
+        namespace: The dict of the global names of the compiled
+            function.
+        expression: The <exp> node of the assignment.
+        identifier: The Id instance assigned.
+        target: The Python expression that holds the value assigned.
+    """
+    governor = bnf_grammar.Prog.governor
+    tracer = bnf_grammar.Prog.tracer
+    return ((governor.emit_assign(namespace, expression.get_line(), target)
+             if governor else [])
+            + ([tracer.emit_assign(namespace, expression, identifier, target)]
+               if tracer else []))
+
+def _branch(namespace: dict, condition: 'bnf_grammar.Cond',
+            outcome: bool) -> list[str]:
+    """Return the source that fires the probe of an outcome, if any.
+
+    The source also records the outcome if a flight recorder has been
+    assigned to the tracer attribute of the Prog class.
+
+    Args:
+        namespace: The dict of the global names of the compiled
+            function.
+        condition: The <cond> node of an <if> or <loop> node.
+        outcome: The Boolean that condition has resolved to.
+    """
+    coverage = bnf_grammar.Prog.coverage
+    tracer = bnf_grammar.Prog.tracer
+    return (([coverage.emit_branch(namespace, condition, outcome)]
+             if coverage else [])
+            + ([tracer.emit_branch(namespace, condition, outcome)]
+               if tracer else []))
+
+def _wrap(source: list[str], namespace: dict) -> list[str]:
+    """Return the source of a compiled function that adds its counts.
+
+    The counts of the statements and iterations of the function are
+    added to the profiler assigned to the profiler attribute of the
+    Prog class, if any, when the function returns, the counts of its
+    statements to the memory report assigned to the memory attribute,
+    and its probes to the coverage assigned to the coverage attribute
+    of that class, if it needs them to be.
+
+    Args:
+        source: The lines of the Python source of the function.
+        namespace: The dict of the global names of the function.
+    """
+    profiler = bnf_grammar.Prog.profiler
+    coverage = bnf_grammar.Prog.coverage
+    if profiler:
+        source = profiler.wrap(source, namespace)
+    if coverage:
+        source = coverage.wrap(source, namespace)
+    memory = bnf_grammar.Prog.memory
+    if memory:
+        source = memory.wrap(source, namespace)
+    return source
+
+def _attach(function: Callable, source: str) -> None:
+    """Watch the probes of a compiled function, if anything covers it."""
+    coverage = bnf_grammar.Prog.coverage
+    if coverage:
+        coverage.attach(function, source)
+
+class Trace:
+    """A recorded iteration of a loop and its compiled replay.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            assign
+            guard
+            call
+            compile
+            enter
+            run
+            is_unstable
+            get_source
+
+        Public instance variables:
+            entries: The number of times the compiled trace has been
+                entered.
+            exits: The number of times a guard of the compiled trace
+                has failed.
+            iterations: The number of loop iterations started in the
+                compiled trace.
+            guards: The number of guards in the trace.
+
+        Private instance variables:
+            _loop: The Loop instance whose iteration was recorded.
+            _ops: a list of tuples, each of which is an operation of
+                the recorded iteration: ('assign', Id, Exp),
+                ('guard', Cond, outcome, exits), or ('call', node).
+            _ids: a list of the Id instances that the compiled trace
+                keeps in Python locals.
+            _ready: a Boolean that is True once every Id instance in
+                _ids has been initialized, after which it stays so.
+            _source: the Python source of the compiled trace.
+            _function: the compiled trace.
+    """
+
+    def __init__(self, loop: 'bnf_grammar.Loop') -> None:
+        self._loop = loop
+        self._ops = []
+        self._ids = []
+        self._ready = False
+        self._source = ''
+        self._function = None
+        self.entries = self.exits = self.iterations = self.guards = 0
+
+    def assign(self, identifier: 'bnf_grammar.Id',
+               expression: 'bnf_grammar.Exp') -> None:
+        """Record an assignment of an <exp> node to an Id instance."""
+        self._ops += [('assign', identifier, expression)]
+
+    def guard(self, condition: 'bnf_grammar.Cond', outcome: bool,
+              exits: tuple['bnf_grammar.StmtSeq', ...]) -> None:
+        """Record the direction taken at an <if> node.
+
+        Args:
+            condition: The <cond> node of the <if> node.
+            outcome: The Boolean that condition resolved to.
+            exits: The <stmt seq> nodes that complete the iteration in
+                the tree-walk if condition resolves otherwise.
+        """
+        self._ops += [('guard', condition, outcome, exits)]
+        self.guards += 1
+
+    def call(self, node: 'bnf_grammar.Loop | bnf_grammar.In | bnf_grammar.Out'
+             ) -> None:
+        """Record a statement that is executed by the tree-walk."""
+        self._ops += [('call', node)]
+
+    def compile(self) -> None:
+        """Translate the recorded operations to a Python function.
+
+        The Id instances that appear in assignments and conditions are
+        loaded into Python locals on entry. Assigned locals are stored
+        back to their Id instances before every call into the
+        tree-walk and on every exit, and all locals are reloaded after
+        every call. The function returns the number of iterations it
+        started and either None, when the loop condition resolves to
+        False, or the exits of the guard that failed.
+        """
+        names = _Locals()
+        assigned, statements, namespace = [], [], {}
+        condition = self._loop.get_condition().compile(names)
+        for index, op in enumerate(self._ops):
+            if op[0] == 'assign':
+                statements += [(op[0], names[op[1]], op[2].compile(names),
+                                op[1], op[2], op[2])]
+                if op[1] not in assigned:
+                    assigned += [op[1]]
+            if op[0] == 'guard':
+                if op[2]:
+                    test = 'not ' + op[1].compile(names)
+                else:
+                    test = op[1].compile(names)
+                namespace['k_{0}'.format(index)] = op[3]
+                statements += [(op[0], test, 'k_{0}'.format(index),
+                                op[1], op[2], op[1])]
+            if op[0] == 'call':
+                namespace['c_{0}'.format(index)] = op[1]
+                statements += [(op[0], 'c_{0}'.format(index), op[1])]
+        self._ids = list(names)
+        for identifier in self._ids:
+            namespace['i_' + identifier.get_name()] = identifier
+        load = ['{0} = i_{1}._value'.format(names[identifier],
+                                             identifier.get_name())
+                for identifier in self._ids]
+        store = ['i_{0}._value = {1}'.format(identifier.get_name(),
+                                             names[identifier])
+                 for identifier in assigned]
+        def name(identifier: 'bnf_grammar.Id') -> str:
+            if identifier in names:
+                return names[identifier]
+            namespace['i_' + identifier.get_name()] = identifier
+            return 'i_{0}._value'.format(identifier.get_name())
+        start, check = _watch(self._loop, name, namespace, 0)
+        source = ['def trace(data):', '    n = 0']
+        source += ['    ' + line for line in load]
+        source += ['    ' + line for line in start]
+        source += ['    while True:', '        n += 1']
+        for statement in statements:
+            count = _count(namespace, statement[-1])
+            if statement[0] == 'assign':
+                source += ['        {0} = {1}'.format(*statement[1:3])]
+                source += ['        ' + line for line in count]
+                source += ['        ' + line for line in _assign(
+                               namespace, statement[4], statement[3],
+                               statement[1])]
+            if statement[0] == 'guard':
+                source += ['        ' + line for line in count]
+                source += ['        if {0}:'.format(statement[1])]
+                source += ['            ' + line for line in _branch(
+                               namespace, statement[3], not statement[4])]
+                source += ['            ' + line for line in store]
+                source += ['            return n, {0}'.format(statement[2])]
+                source += ['        ' + line for line in _branch(
+                               namespace, statement[3], statement[4])]
+            if statement[0] == 'call':
+                source += ['        ' + line for line in count]
+                source += ['        ' + line for line in store]
+                source += ['        {0}.execute(data)'.format(statement[1])]
+                source += ['        ' + line for line in load]
+        source += ['        if not {0}:'.format(condition)]
+        source += ['            ' + line for line in _branch(
+                       namespace, self._loop.get_condition(), False)]
+        source += ['            ' + line for line in store]
+        source += ['            return n, None']
+        source += ['        ' + line for line in _branch(
+                       namespace, self._loop.get_condition(), True)]
+        source += ['        ' + line for line in check]
+        self._source = '\n'.join(_wrap(source, namespace)) + '\n'
+        exec(compile(self._source,
+                     '<trace of loop at line {0}>'.format(
+                         self._loop.get_line()), 'exec'), namespace)
+        self._function = namespace['trace']
+        _attach(self._function, self._source)
+
+    def enter(self) -> bool:
+        """Return whether the compiled trace may be entered.
+
+        The compiled trace does not check identifiers for
+        initialization, so it may only be entered once every Id
+        instance that it keeps in a local has been initialized.
+        """
+        if not self._ready:
+            self._ready = all(identifier.is_initialized()
+                              for identifier in self._ids)
+        return self._ready
+
+    def run(self, data: TextIO) -> tuple['bnf_grammar.StmtSeq', ...] | None:
+        """Run the compiled trace from the loop header.
+
+        Args:
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+
+        Returns:
+            None if the loop condition resolved to False, or the
+            <stmt seq> nodes that complete the current iteration in the
+            tree-walk if a guard failed.
+        """
+        self.entries += 1
+        iterations, exits = self._function(data)
+        self.iterations += iterations
+        if exits is not None:
+            self.exits += 1
+        return exits
+
+    def is_unstable(self) -> bool:
+        """Return whether guards fail too often for the trace to pay."""
+        return (self.exits >= BLACKLIST_EXITS and self.iterations
+                < self.exits * BLACKLIST_ITERATIONS_PER_EXIT)
+
+    def get_source(self) -> str:
+        """Return the Python source of the compiled trace."""
+        return self._source
+
+class _LoopProfile:
+    """The execution counters of a <loop> node."""
+
+    def __init__(self, threshold: int) -> None:
+        self.back_edges = 0
+        self.next_recording = threshold
+        self.recordings = 0
+        self.trace = None
+        self.retired = []
+
+class TracingJit:
+    """An execution engine that traces and compiles hot loops.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            execute_loop
+            dump_stats
+
+        Private instance variables:
+            _threshold: The number of back-edges of a loop after which
+                an iteration of the loop is recorded.
+            _profiles: a dict whose keys are Loop instances and whose
+                values are the _LoopProfile instances that count their
+                executions.
+    """
+
+    def __init__(self, threshold: int = 100) -> None:
+        self._threshold = threshold
+        self._profiles = {}
+
+    def execute_loop(self, loop: 'bnf_grammar.Loop', data: TextIO) -> None:
+        """Execute a <loop> node, tracing it once it becomes hot.
+
+        Tree-walk the loop while counting its back-edges. Record an
+        iteration when the count reaches the threshold, and enter the
+        compiled trace at the header of every subsequent iteration.
+        Retire a trace whose guards fail too often, and record another
+        one after a further threshold of back-edges unless the loop
+        has already been recorded MAX_RECORDINGS times.
+
+        Args:
+            loop: The Loop instance to execute.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+        """
+        profile = self._profiles.get(loop)
+        if not profile:
+            profile = self._profiles[loop] = _LoopProfile(self._threshold)
+        condition, line = loop.get_condition(), loop.get_line()
+        stmt_seq = loop.get_stmt_seq()
+        header = loop.watch()
+        while condition.evaluate(data, line):
+            if header:
+                header(data)
+            trace = profile.trace
+            if trace and trace.enter():
+                iterations = trace.iterations
+                exits = trace.run(data)
+                profile.back_edges += trace.iterations - iterations
+                if exits is None:
+                    break
+                for exit_stmt_seq in exits:
+                    exit_stmt_seq.execute(data)
+                if trace.is_unstable():
+                    profile.retired += [trace]
+                    profile.trace = None
+                    profile.next_recording = (profile.back_edges
+                                              + self._threshold)
+            elif (not trace and profile.recordings < MAX_RECORDINGS
+                    and profile.back_edges >= profile.next_recording):
+                trace = Trace(loop)
+                stmt_seq.record(data, trace, ())
+                trace.compile()
+                profile.trace = trace
+                profile.recordings += 1
+                profile.back_edges += 1
+            else:
+                stmt_seq.execute(data)
+                profile.back_edges += 1
+
+    def dump_stats(self, file: TextIO = sys.stderr) -> None:
+        """Print the counters of every executed loop.
+
+        Args:
+            file: The text stream to print the counters to.
+        """
+        print('Tracing JIT statistics (threshold: {0})'
+              .format(self._threshold), file = file)
+        for loop, profile in sorted(self._profiles.items(),
+                                    key = lambda item: item[0].get_line()):
+            traces = profile.retired + ([profile.trace] if profile.trace
+                                        else [])
+            print('  loop at line {0}: {1} iterations, {2} traced, '
+                  '{3} recording(s)'
+                  .format(loop.get_line(), profile.back_edges,
+                          sum(trace.iterations for trace in traces),
+                          profile.recordings), file = file)
+            for trace in traces:
+                print('    {0} trace: {1} guard(s), {2} entries, '
+                      '{3} guard exit(s)'
+                      .format('active' if trace is profile.trace
+                              else 'retired', trace.guards, trace.entries,
+                              trace.exits), file = file)
+
+class LoopCompiler:
+    """A translator of a whole <loop> node to a Python function.
+
+    The "compile" methods of the statement classes of the APT call the
+    public methods of this class, which emit the Python statements.
+
+    In int64 mode, the identifiers that the loop assigns are given a
+    slot in a state vector, an array('q') of 64-bit signed integers.
+    They are computed in Python locals, and written back to their slots
+    only when the compiled code stores them, on exit and before a call
+    into the tree-walk, so that the array range-checks them there at no
+    cost per iteration. An OverflowError leaves the compiled code for
+    the tree-walk at the statement before which they were stored.
+    Identifiers in the bigint set, as well as identifiers that are not
+    initialized or whose values do not fit in 64 bits when the loop is
+    compiled, have no slot and the semantics of unbounded integers.
+    Identifiers in the proven set are proven by the value-range analysis
+    of the ranges module never to leave 64 bits, so they have no slot
+    either and are never range-checked.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            assign
+            branch
+            orelse
+            loop
+            end
+            call
+            compile
+
+        Private instance methods:
+            _name
+            _emit
+            _watch
+            _count
+            _constant
+            _expression
+
+        Public instance variables:
+            resume: The nodes that resume the tree-walk at the
+                statement being translated. It is set by the "compile"
+                methods of StmtSeq instances.
+
+        Private instance variables:
+            _loop: The Loop instance being translated.
+            _bigint: The set of Id instances that are never held in the
+                state vector, or None if not in int64 mode.
+            _proven: The set of Id instances held in Python locals
+                without range checks in int64 mode.
+            _names: a _Locals instance that names the Python local of
+                every Id instance that appears in the loop.
+            _slots: a list of the Id instances that have a slot in the
+                state vector, in the order of their slots.
+            _assigned: a list of the Id instances that are assigned in
+                the loop.
+            _lines: a list of the translated lines of Python source.
+            _depth: the indentation level of the next line.
+            _branches: a stack of the <cond> nodes of the open <if>
+                nodes without an else-branch so far, and None for the
+                other open <if> and <loop> nodes.
+            _namespace: a dict of the global names of the function.
+    """
+
+    def __init__(self, loop: 'bnf_grammar.Loop',
+                 bigint: set['bnf_grammar.Id'] | None = None,
+                 proven: set['bnf_grammar.Id'] = frozenset()) -> None:
+        self._loop = loop
+        self._bigint = bigint
+        self._proven = proven
+        self._names = _Locals(self._name)
+        self._slots = []
+        self._assigned = []
+        self._lines = []
+        self._depth = 2 if bigint is None else 3
+        self._branches = []
+        self._namespace = {}
+        self.resume = ()
+
+    def _name(self, identifier: 'bnf_grammar.Id') -> str:
+        """Return the Python local of an Id, and give it a slot if due."""
+        if (self._bigint is not None and identifier not in self._bigint
+                and identifier not in self._proven
+                and identifier.is_initialized()):
+            if INT64_MIN <= identifier._value <= INT64_MAX:
+                self._slots += [identifier]
+            else:
+                self._bigint.add(identifier)
+        return 'v_' + identifier.get_name()
+
+    def _emit(self, line: str) -> None:
+        """Append a line of source at the current indentation level."""
+        self._lines += ['    ' * self._depth + line]
+
+    def _watch(self, loop: 'bnf_grammar.Loop'
+               ) -> tuple[list[str], list[str]]:
+        """Return the source that checks the headers of a loop, if any.
+
+        Returns:
+            The lines to run before the loop and the lines to run at
+            every header, both empty if nothing checks the loop.
+        """
+        return _watch(loop, lambda identifier: self._names[identifier],
+                      self._namespace, len(self._namespace))
+
+    def _count(self, node: object) -> None:
+        """Emit the count of a statement, if anything counts it."""
+        for source in _count(self._namespace, node):
+            self._emit(source)
+
+    def _branch(self, condition: 'bnf_grammar.Cond', outcome: bool) -> None:
+        """Emit the probe of an outcome of a condition, if anything has one."""
+        for source in _branch(self._namespace, condition, outcome):
+            self._emit(source)
+
+    def _constant(self, prefix: str, value: object) -> str:
+        """Bind a value to a new global name of the function."""
+        name = '{0}_{1}'.format(prefix, len(self._namespace))
+        self._namespace[name] = value
+        return name
+
+    def _expression(self, node: 'bnf_grammar.Exp | bnf_grammar.Cond',
+                    resume: tuple['bnf_grammar.StmtSeq | bnf_grammar.Loop',
+                                  ...]) -> str:
+        """Translate an <exp> or <cond> node to a Python expression.
+
+        If the node reads identifiers that were not initialized when
+        the loop was compiled, then emit a check that leaves the
+        compiled code for the tree-walk at resume while any of them is
+        still not initialized.
+
+        Args:
+            node: The Exp or Cond instance to translate.
+            resume: The nodes that resume the tree-walk at the
+                statement that evaluates node.
+
+        Returns:
+            The translated Python expression.
+        """
+        self._names.reads = set()
+        expression = node.compile(self._names)
+        uninitialized = sorted(self._names[identifier] for identifier
+                               in self._names.reads
+                               if not identifier.is_initialized())
+        if uninitialized:
+            self._emit('if {0}:'.format(' or '.join(
+                name + ' is None' for name in uninitialized)))
+            resume = self._constant('k', resume)
+            self._emit('    {0}  # {1}'.format(_STORE, resume))
+            self._emit('    return n, {0}'.format(resume))
+        return expression
+
+    def assign(self, identifier: 'bnf_grammar.Id',
+               expression: 'bnf_grammar.Exp') -> None:
+        """Emit an assignment of an <exp> node to an Id instance."""
+        source = self._expression(expression, self.resume)
+        target = self._names[identifier]
+        self._emit('{0} = {1}'.format(target, source))
+        self._count(expression)
+        for line in _assign(self._namespace, expression, identifier, target):
+            self._emit(line)
+        if identifier not in self._assigned:
+            self._assigned += [identifier]
+
+    def branch(self, condition: 'bnf_grammar.Cond') -> None:
+        """Emit the header of the then-branch of an <if> node."""
+        test = self._expression(condition, self.resume)
+        self._count(condition)
+        self._emit('if {0}:'.format(test))
+        self._depth += 1
+        self._branch(condition, True)
+        self._branches.append(condition)
+
+    def orelse(self) -> None:
+        """Emit the header of the else-branch of an <if> node."""
+        condition = self._branches.pop()
+        self._depth -= 1
+        self._emit('else:')
+        self._depth += 1
+        self._branch(condition, False)
+        self._branches.append(None)
+
+    def loop(self, loop: 'bnf_grammar.Loop',
+             resume: tuple['bnf_grammar.StmtSeq | bnf_grammar.Loop', ...]
+             ) -> None:
+        """Emit the header of a nested <loop> node.
+
+        Args:
+            loop: The nested Loop instance.
+            resume: The nodes that resume the tree-walk at the header
+                of the loop.
+        """
+        start, check = self._watch(loop)
+        self._count(loop)
+        for line in start:
+            self._emit(line)
+        self._emit('while True:')
+        self._depth += 1
+        self._emit('if not {0}:'.format(self._expression(
+            loop.get_condition(), resume)))
+        self._depth += 1
+        self._branch(loop.get_condition(), False)
+        self._depth -= 1
+        self._emit('    break')
+        self._branch(loop.get_condition(), True)
+        for line in check:
+            self._emit(line)
+        self._branches.append(None)
+
+    def end(self) -> None:
+        """Close the innermost <if> or <loop> node.
+
+        The probe of the else-branch of an <if> node that has none is
+        emitted in an else-branch of its own.
+        """
+        condition = self._branches.pop()
+        self._depth -= 1
+        probes = condition and _branch(self._namespace, condition, False)
+        if probes:
+            self._emit('else:')
+            for line in probes:
+                self._emit('    ' + line)
+
+    def call(self, node: 'bnf_grammar.In | bnf_grammar.Out') -> None:
+        """Emit a call of a statement into the tree-walk.
+
+        The assigned identifiers are stored to their Id instances
+        before the call, and every identifier is reloaded after it.
+        Should storing them overflow, the tree-walk resumes at the
+        statement called.
+
+        Args:
+            node: The In or Out instance to call.
+        """
+        self._count(node)
+        self._emit('{0}  # {1}'.format(_STORE,
+                                       self._constant('k', self.resume)))
+        self._emit('{0}.execute(data)'.format(self._constant('c', node)))
+        self._emit(_LOAD)
+
+    def compile(self) -> tuple[object, str, dict[int, tuple]]:
+        """Translate the loop to a Python function.
+
+        The function is entered after the condition of the loop has
+        resolved to True, and it runs the remaining iterations of the
+        loop. It returns the number of iterations it started and either
+        None, when the loop condition resolves to False, the nodes that
+        resume the tree-walk if it had to leave early, or, in int64
+        mode, the number of the line of its source that overflowed.
+        Every identifier is stored to its Id instance before it returns,
+        even when a line overflows, since the Python locals hold the
+        exact values.
+
+        Returns:
+            The compiled function, its Python source, and a dict whose
+            keys are the numbers of the lines that may overflow and
+            whose values are tuples of the nodes that resume the
+            tree-walk and the Id instance that overflowed.
+        """
+        self._loop.get_stmt_seq().compile(self, ())
+        body = self._lines
+        self._lines, self._depth = [], self._depth - 1
+        self._emit('    if not {0}:'.format(
+            self._expression(self._loop.get_condition(), ())))
+        self._depth += 2
+        self._branch(self._loop.get_condition(), False)
+        self._depth -= 2
+        self._emit('        break')
+        self._depth += 1
+        self._branch(self._loop.get_condition(), True)
+        self._depth -= 1
+        start, check = self._watch(self._loop)
+        for line in check:
+            self._emit('    ' + line)
+        header = self._lines
+        ids = sorted(self._names, key = lambda identifier:
+                     identifier.get_name())
+        load, store, checks = [], [], []
+        for identifier in ids:
+            target = self._names[identifier]
+            name = 'i_' + identifier.get_name()
+            self._namespace[name] = identifier
+            if identifier.is_initialized():
+                load += ['{0} = {1}._value'.format(target, name)]
+            else:
+                load += ['{0} = {1}._value if {1}._initialized else None'
+                         .format(target, name)]
+        for identifier in sorted(self._assigned, key = lambda identifier:
+                                 identifier.get_name()):
+            target = self._names[identifier]
+            name = 'i_' + identifier.get_name()
+            if identifier.is_initialized():
+                store += ['{0}._value = {1}'.format(name, target)]
+            else:
+                store += ['if {1} is not None: {0}.set_value({1})'
+                          .format(name, target)]
+            if identifier in self._slots:
+                checks += [('s[{0}] = {1}'.format(
+                    self._slots.index(identifier), target), identifier)]
+        done = self._constant('k', ())
+        if self._bigint is None:
+            source = ['def loop(data):', '    n = 0', '    ' + _LOAD]
+            source += ['    ' + line for line in start]
+            source += ['    while True:', '        n += 1']
+            source += body + header + ['    {0}  # {1}'.format(_STORE, done),
+                                       '    return n, None']
+        else:
+            self._namespace['s'] = array.array('q', [0] * len(self._slots))
+            source = ['def loop(data):', '    n = 0', '    try:',
+                      '        ' + _LOAD]
+            source += ['        ' + line for line in start]
+            source += ['        while True:', '            n += 1']
+            source += body + header
+            source += ['        {0}  # {1}'.format(_STORE, done),
+                       '    except OverflowError as error:']
+            source += ['        ' + line for line in store]
+            source += ['        return n, error.__traceback__.tb_lineno',
+                       '    return n, None']
+        expanded, overflows = [], {}
+        for line in _wrap(source, self._namespace):
+            indent = line[:len(line) - len(line.lstrip())]
+            statement, _, resume = line.lstrip().partition('  # ')
+            if statement == _STORE:
+                for check, identifier in checks:
+                    expanded += [indent + check]
+                    overflows[len(expanded)] = (self._namespace[resume],
+                                                identifier)
+            if statement in (_STORE, _LOAD):
+                lines = store if statement == _STORE else load
+                expanded += [indent + text for text in lines or ['pass']]
+            else:
+                expanded += [line]
+        source = '\n'.join(expanded) + '\n'
+        exec(compile(source, '<compiled loop at line {0}>'.format(
+            self._loop.get_line()), 'exec'), self._namespace)
+        _attach(self._namespace['loop'], source)
+        return self._namespace['loop'], source, overflows
+
+class _TierProfile:
+    """The tier and execution counters of a <loop> node."""
+
+    def __init__(self) -> None:
+        self.tier = 0
+        self.iterations = [0, 0]
+        self.compiled_at = None
+        self.entries = 0
+        self.exits = 0
+        self.function = None
+        self.source = ''
+        self.overflows = {}
+        self.recompilations = 0
+
+class TieredEngine:
+    """An execution engine that compiles hot loops on the fly.
+
+    In int64 mode, loops are compiled with a state vector of 64-bit
+    integers. When an identifier overflows, it is moved to the bigint
+    set for the rest of the run, the loop is recompiled, and the
+    tree-walk resumes at the statement before which it was stored. Identifiers
+    that the value-range analysis proves to fit in 64 bits are never
+    range-checked.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            execute_loop
+            dump_stats
+
+        Private instance methods:
+            _compile
+
+        Private instance variables:
+            _threshold: The number of tier 0 iterations of a loop after
+                which the loop is compiled.
+            _bigint: The set of Id instances with the semantics of
+                unbounded integers in int64 mode, or None if not in
+                int64 mode.
+            _proven: The set of Id instances proven to fit in 64 bits
+                by the value-range analysis.
+            _profiles: a dict whose keys are Loop instances and whose
+                values are the _TierProfile instances that count their
+                executions.
+    """
+
+    def __init__(self, threshold: int = 100, int64: bool = False,
+                 proven: set['bnf_grammar.Id'] = frozenset()) -> None:
+        self._threshold = threshold
+        self._bigint = set() if int64 else None
+        self._proven = proven
+        self._profiles = {}
+
+    def execute_loop(self, loop: 'bnf_grammar.Loop', data: TextIO) -> None:
+        """Execute a <loop> node, moving it to tier 1 once it is hot.
+
+        Tree-walk the loop while counting its iterations. When the
+        count reaches the threshold, compile the loop, and hand the
+        remaining iterations to the compiled function on the next
+        back-edge. Should the compiled function leave early, complete
+        the iteration it left in the tree-walk and enter it again on
+        the following back-edge.
+
+        Args:
+            loop: The Loop instance to execute.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+        """
+        profile = self._profiles.get(loop)
+        if not profile:
+            profile = self._profiles[loop] = _TierProfile()
+        condition, line = loop.get_condition(), loop.get_line()
+        stmt_seq = loop.get_stmt_seq()
+        header = loop.watch()
+        while condition.evaluate(data, line):
+            if header:
+                header(data)
+            if profile.function:
+                profile.entries += 1
+                iterations, exits = profile.function(data)
+                profile.iterations[1] += iterations
+                if exits is None:
+                    break
+                profile.exits += 1
+                if isinstance(exits, int):
+                    exits, identifier = profile.overflows[exits]
+                    if identifier:
+                        self._bigint.add(identifier)
+                    self._compile(loop, profile)
+                    profile.recompilations += 1
+                for exit_node in exits:
+                    exit_node.execute(data)
+            else:
+                stmt_seq.execute(data)
+                profile.iterations[0] += 1
+                if profile.iterations[0] >= self._threshold:
+                    self._compile(loop, profile)
+                    profile.tier = 1
+                    profile.compiled_at = profile.iterations[0]
+
+    def _compile(self, loop: 'bnf_grammar.Loop',
+                 profile: _TierProfile) -> None:
+        """Compile a loop, and keep the result in its profile."""
+        profile.function, profile.source, profile.overflows = (
+            LoopCompiler(loop, self._bigint, self._proven).compile())
+
+    def dump_stats(self, file: TextIO = sys.stderr) -> None:
+        """Print the tier and counters of every executed loop.
+
+        Args:
+            file: The text stream to print the counters to.
+        """
+        print('Tiered engine statistics (compile threshold: {0})'
+              .format(self._threshold), file = file)
+        for loop, profile in sorted(self._profiles.items(),
+                                    key = lambda item: item[0].get_line()):
+            print('  loop at line {0}: tier {1}, {2} iteration(s) in tier '
+                  '0, {3} in tier 1'
+                  .format(loop.get_line(), profile.tier,
+                          *profile.iterations), file = file)
+            if profile.tier:
+                print('    compiled after {0} iteration(s), {1} entries, '
+                      '{2} exit(s) to tier 0, {3} recompilation(s)'
+                      .format(profile.compiled_at, profile.entries,
+                              profile.exits, profile.recompilations),
+                      file = file)
+        if self._bigint is not None:
+            print('  identifiers moved to bigint: {0}'.format(
+                ', '.join(sorted(identifier.get_name() for identifier
+                                 in self._bigint)) or 'none'), file = file)
+            print('  identifiers proven to fit in int64: {0}'.format(
+                ', '.join(sorted(identifier.get_name() for identifier
+                                 in self._proven)) or 'none'), file = file)
@@ -0,0 +1,316 @@
+"""This module provides the statement and branch coverage of Core programs.
+
+An instance of the Coverage class records which statements of a Core
+program have been executed, and which outcomes the conditions of its
+"if" and "while" statements have resolved to: the then-branch or the
+else-branch of an "if" statement, whether or not it has an else-branch,
+and the entry into the body of a "while" statement or its exit. The
+dump method writes them as a tracefile in the lcov format, with a DA
+record for every line that holds a statement, whose count is the number
+of the statements starting on the line that have been executed, and two
+BRDA records for every condition, numbered in the order of the APT
+within their line.
+
+Every statement and condition is covered by probes that are disabled
+once they have fired, so that the execution runs at full speed once its
+paths have been covered:
+    - In the tree-walk, every Stmt instance of the bnf_grammar module,
+      the Cond instance of every "if" and "while" statement, and the
+      Loop instance of every "while" statement, is armed by its
+      set_probed method, which installs the instrumented version of its
+      "execute" or "evaluate" method on the node alone. The fire,
+      branch, or exit method disarms the node once it, or both of its
+      outcomes, have been recorded, which removes that method, so that
+      the node executes through the method of its class again. The exit
+      of a "while" statement is recorded by its Loop instance when the
+      loop returns, so that its condition is disarmed once it has
+      resolved to True rather than at every iteration until the loop
+      exits. The condition of an "if" statement stays armed until both
+      of its outcomes have been recorded, and only the trace engine's
+      recording, which tests a flag of the node, still pays for a
+      covered statement.
+    - In the code compiled by the engines of the jit module, every
+      statement and every outcome of a condition is followed by an
+      assignment of 1 to a local named after its probe. On Python 3.12
+      and later, the line of the assignment fires a LINE event of
+      sys.monitoring, whose callback records the probe and disables the
+      event of the line. On earlier versions, the compiled function
+      records the probes whose locals have been assigned when it
+      returns.
+Probes are armed and emitted only through the coverage hook of the
+Prog class of the bnf_grammar module, as its instrument function
+describes.
+"""
+
+import os
+import re
+import sys
+from typing import Callable, TextIO
+
+import bnf_grammar
+import metrics
+
+_PROBE = re.compile(r'\s*u_(\d+) = 1')
+
+def _counted(statement: 'bnf_grammar.Stmt') -> object:
+    """Return the node that compiled code counts a statement by.
+
+    That is the <exp> node of an assignment, the <cond> node of an "if"
+    statement, or the Loop, In, or Out instance of the statement.
+    """
+    node = metrics.children(statement)[0]
+    if isinstance(node, bnf_grammar.Assign):
+        return node.get_expression()
+    if isinstance(node, bnf_grammar.If):
+        return node.get_condition()
+    return node
+
+class Coverage:
+    """The probes of a Core program and the probes that have fired.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            start
+            stop
+            fire
+            branch
+            exit
+            emit
+            emit_branch
+            wrap
+            attach
+            dump
+
+        Private instance methods:
+            _probe
+            _collect
+            _line_event
+
+        Private instance variables:
+            _probes: a dict whose keys are Stmt instances, or tuples of
+                a Cond instance and an outcome, and whose values are
+                the numbers of their probes.
+            _counted: a dict whose keys are the nodes that compiled
+                code counts statements by, and whose values are their
+                Stmt instances.
+            _fired: a set of the numbers of the probes that have fired.
+            _statements: a list of the Stmt instances of the program, in
+                the order of the APT.
+            _conditions: a list of the Cond instances of the "if" and
+                "while" statements of the program, in the order of the
+                APT.
+            _loops: a dict whose keys are the Cond instances of the
+                "while" statements of the program, and whose values are
+                their Loop instances.
+            _lines: a dict whose keys are compiled code objects and
+                whose values are dicts from their line numbers to the
+                numbers of the probes on the lines.
+            _tool: the identifier of the sys.monitoring tool, or None if
+                the compiled functions record their probes.
+    """
+
+    def __init__(self) -> None:
+        self._probes = {}
+        self._counted = {}
+        self._fired = set()
+        self._statements = []
+        self._conditions = []
+        self._loops = {}
+        self._lines = {}
+        self._tool = None
+
+    def start(self, program: 'bnf_grammar.Prog') -> None:
+        """Arm the probes of the tree-walk before the program executes.
+
+        Args:
+            program: The parsed Core program.
+        """
+        for node in metrics.walk(program):
+            if isinstance(node, bnf_grammar.Stmt):
+                self._statements.append(node)
+                self._counted[_counted(node)] = node
+                self._probe(node)
+                node.set_probed(True)
+            elif isinstance(node, (bnf_grammar.If, bnf_grammar.Loop)):
+                condition = node.get_condition()
+                self._conditions.append(condition)
+                self._probe((condition, True))
+                self._probe((condition, False))
+                condition.set_probed(True)
+                if isinstance(node, bnf_grammar.Loop):
+                    self._loops[condition] = node
+                    node.set_probed(True)
+        monitoring = getattr(sys, 'monitoring', None)
+        if monitoring:
+            for tool in (monitoring.COVERAGE_ID,) + tuple(range(6)):
+                if monitoring.get_tool(tool) is None:
+                    monitoring.use_tool_id(tool, 'core coverage')
+                    monitoring.register_callback(
+                        tool, monitoring.events.LINE, self._line_event)
+                    self._tool = tool
+                    break
+
+    def stop(self) -> None:
+        """Disarm the probes of the tree-walk, and release the tool."""
+        for node in (self._statements + self._conditions
+                     + list(self._loops.values())):
+            node.set_probed(False)
+        if self._tool is not None:
+            for code in self._lines:
+                sys.monitoring.set_local_events(self._tool, code, 0)
+            sys.monitoring.register_callback(
+                self._tool, sys.monitoring.events.LINE, None)
+            sys.monitoring.free_tool_id(self._tool)
+            self._tool = None
+
+    def _probe(self, key: object) -> int:
+        """Return the number of the probe of a statement or an outcome."""
+        return self._probes.setdefault(key, len(self._probes))
+
+    def fire(self, statement: 'bnf_grammar.Stmt') -> bool:
+        """Record the execution of a statement by the tree-walk.
+
+        Returns:
+            False, to disarm the probe of the statement.
+        """
+        self._fired.add(self._probes[statement])
+        return False
+
+    def branch(self, condition: 'bnf_grammar.Cond', outcome: bool) -> bool:
+        """Record an outcome of a condition evaluated by the tree-walk.
+
+        Returns:
+            Whether the probe of the condition stays armed, until both
+            of its outcomes have been recorded, or until the condition
+            of a "while" statement, whose exit its Loop instance
+            records, has resolved to True.
+        """
+        self._fired.add(self._probes[(condition, outcome)])
+        if outcome and condition in self._loops:
+            return False
+        return self._probes[(condition, not outcome)] not in self._fired
+
+    def exit(self, loop: 'bnf_grammar.Loop') -> bool:
+        """Record the exit of a loop executed by the tree-walk.
+
+        A loop that returns has resolved its condition to False.
+
+        Returns:
+            False, to disarm the probe of the loop.
+        """
+        self._fired.add(self._probes[(loop.get_condition(), False)])
+        return False
+
+    def emit(self, namespace: dict, node: object) -> str:
+        """Return the Python source of the probe of a compiled statement.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function.
+            node: The node that compiled code counts the statement by.
+        """
+        return 'u_{0} = 1'.format(self._probe(self._counted[node]))
+
+    def emit_branch(self, namespace: dict, condition: 'bnf_grammar.Cond',
+                    outcome: bool) -> str:
+        """Return the Python source of the probe of a compiled outcome.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function.
+            condition: The Cond instance of an "if" or "while" statement.
+            outcome: The Boolean that condition has resolved to where
+                the probe is emitted.
+        """
+        return 'u_{0} = 1'.format(self._probe((condition, outcome)))
+
+    def wrap(self, source: list[str], namespace: dict) -> list[str]:
+        """Record the probes of a compiled function when it returns.
+
+        Without sys.monitoring, the probes whose locals the function
+        has assigned are recorded however it returns.
+
+        Args:
+            source: The lines of the Python source of the function,
+                the first of which is its "def" statement.
+            namespace: The dict of the global names of the function.
+
+        Returns:
+            The lines of the wrapped function.
+        """
+        if self._tool is not None:
+            return source
+        namespace['u_collect'] = self._collect
+        return ([source[0], '    try:']
+                + ['    ' + line for line in source[1:]]
+                + ['    finally:', '        u_collect(locals())'])
+
+    def _collect(self, names: dict) -> None:
+        """Record the probes among the locals of a compiled function."""
+        self._fired.update(int(name[2:]) for name in names
+                           if name.startswith('u_'))
+
+    def attach(self, function: Callable, source: str) -> None:
+        """Watch the lines of the probes of a compiled function.
+
+        With sys.monitoring, a LINE event fires at the first execution
+        of every line of the function, after which it is disabled.
+
+        Args:
+            function: The compiled function.
+            source: The Python source of the function.
+        """
+        if self._tool is None:
+            return
+        code = function.__code__
+        self._lines[code] = {
+            number: int(match.group(1))
+            for number, match in enumerate(map(_PROBE.fullmatch,
+                                               source.split('\n')), 1)
+            if match}
+        sys.monitoring.set_local_events(self._tool, code,
+                                        sys.monitoring.events.LINE)
+
+    def _line_event(self, code: object, line: int) -> object:
+        """Record the probe on a line of compiled code, and disable it."""
+        probe = self._lines.get(code, {}).get(line)
+        if probe is not None:
+            self._fired.add(probe)
+        return sys.monitoring.DISABLE
+
+    def dump(self, path: str, program: str) -> None:
+        """Write the coverage to a file in the lcov tracefile format.
+
+        Args:
+            path: The path of the file.
+            program: The path of the Core program.
+        """
+        counts = {}
+        for statement in self._statements:
+            counts[statement.get_line()] = (
+                counts.get(statement.get_line(), 0)
+                + (self._probes[statement] in self._fired))
+        lines = sorted(counts)
+        records = ['TN:', 'SF:' + os.path.abspath(program)]
+        blocks, branches = {}, []
+        for condition in self._conditions:
+            line = condition.get_line()
+            block = blocks[line] = blocks.get(line, -1) + 1
+            taken = [self._probes[(condition, outcome)] in self._fired
+                     for outcome in (True, False)]
+            for branch in range(2):
+                branches.append((line, block, branch,
+                                 int(taken[branch]) if any(taken) else '-'))
+        branches.sort(key = lambda branch: branch[:3])
+        records += ['BRDA:{0},{1},{2},{3}'.format(*branch)
+                    for branch in branches]
+        records += ['BRF:{0}'.format(len(branches)),
+                    'BRH:{0}'.format(sum(1 for branch in branches
+                                         if branch[3] == 1))]
+        records += ['DA:{0},{1}'.format(line, counts[line]) for line in lines]
+        records += ['LF:{0}'.format(len(lines)),
+                    'LH:{0}'.format(sum(1 for line in lines if counts[line])),
+                    'end_of_record']
+        with open(path, 'w') as file:
+            file.write('\n'.join(records) + '\n')
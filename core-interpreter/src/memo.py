@@ -0,0 +1,313 @@
+"""This module provides the loop summarization cache of the Core interpreter.
+
+An instance of the MemoizingEngine class takes over the execution of
+<loop> nodes when it is assigned to the engine attribute of the Loop
+class of the bnf_grammar module. The first time it meets a loop, it
+summarizes the loop by calling the "summarize" methods of the APT,
+which report to an instance of the LoopSummary class. A loop is pure
+if neither it nor any loop nested in it contains a "read" or "write"
+statement. The read set of a loop holds the identifiers whose values
+on entry may be read by the loop, that is, those read before they are
+assigned on some path through it, and the write set holds the
+identifiers it may assign.
+
+The execution of a pure loop is a function of the values of its read
+set on entry: the path taken through the loop, and therefore which
+identifiers are assigned and the values they end with, only depends on
+them. Every pure loop has a bounded LRU cache whose keys are the entry
+values of its read set and whose values are the identifiers assigned
+by an execution and their values on exit. A loop entered with a cached
+key is not executed; its exit values are restored from the cache
+instead.
+
+Every cache entry also keeps what the execution added to the counters
+of the resource governor, the metrics, the line profiler, and the
+memory report assigned to the Prog class of the bnf_grammar module, if
+any, and a hit adds it again, so that the limits and counts are those
+of the tree-walk. A hit that would exceed the step limit executes the
+loop instead, so that the run ends where the tree-walk ends it. The
+probes of a coverage need nothing: the execution that filled the entry
+took the same path.
+"""
+
+import collections
+import sys
+from typing import TextIO
+
+import bnf_grammar
+
+DEFAULT_CAPACITY = 1024
+
+def _counts() -> tuple[dict, ...]:
+    """Return the dicts of counts of the line profiler and memory report."""
+    profiler = bnf_grammar.Prog.profiler
+    memory = bnf_grammar.Prog.memory
+    return (((profiler.walked, profiler.compiled, profiler.iterations)
+             if profiler else ())
+            + ((memory.statements, memory.compiled) if memory else ()))
+
+def _snapshot() -> tuple:
+    """Return the counters that an execution of a loop advances.
+
+    Returns:
+        The back-edges counted by the resource governor, the statements
+        counted by the metrics, and copies of the dicts of counts of the
+        line profiler and of the memory report, where they are enabled,
+        or else 0 and ().
+    """
+    governor = bnf_grammar.Prog.governor
+    metrics = bnf_grammar.Prog.metrics
+    return (governor.get_steps() if governor else 0,
+            metrics.statements if metrics else 0,
+            tuple(dict(counts) for counts in _counts()))
+
+def _since(before: tuple) -> tuple:
+    """Return what the counters have advanced by since a snapshot."""
+    after = _snapshot()
+    return (after[0] - before[0], after[1] - before[1],
+            tuple({line: count - old.get(line, 0)
+                   for line, count in new.items()
+                   if count != old.get(line, 0)}
+                  for new, old in zip(after[2], before[2])))
+
+def _charge(counts: tuple, data: TextIO, line: int) -> bool:
+    """Advance the counters as an execution of a loop did.
+
+    Args:
+        counts: What the execution advanced the counters by, as
+            returned by _since().
+        data: A datafile.DataFile or prefetch.PrefetchingDataFile
+            instance, whose next_value() method returns the next input
+            value for a "read" statement in the Core program, and whose
+            fail() method reports why there is none.
+        line: The line whereat the loop appears in the Core program.
+
+    Returns:
+        False, without advancing any counter, if the execution would
+        exceed the step limit of the resource governor; True otherwise.
+    """
+    governor = bnf_grammar.Prog.governor
+    if governor and not governor.charge(counts[0], data, line):
+        return False
+    metrics = bnf_grammar.Prog.metrics
+    if metrics:
+        metrics.statements += counts[1]
+    for total, delta in zip(_counts(), counts[2]):
+        for counted, count in delta.items():
+            total[counted] += count
+    return True
+
+class _Reads(dict):
+    """A dict that collects the Id instances an expression is asked for."""
+
+    def __missing__(self, identifier: 'bnf_grammar.Id') -> str:
+        self[identifier] = identifier.get_name()
+        return self[identifier]
+
+class LoopSummary:
+    """The purity, read set, and write set of a <loop> node.
+
+    The "summarize" methods of the statement classes of the APT call
+    the "use", "define", and "perform_io" methods of this class while
+    they walk the loop in order, passing the set of identifiers that
+    are assigned on every path from the loop entry to the statement.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            use
+            define
+            perform_io
+            get_line
+
+        Public instance variables:
+            pure: Whether the loop is free of "read" and "write"
+                statements.
+            reads: a list of the Id instances in the read set.
+            writes: a list of the Id instances in the write set.
+            cache: a collections.OrderedDict whose keys are tuples of
+                the saved states of the read set on entry and whose
+                values are tuples of the saved states of the write set
+                on exit, of those it entered with, and of what the
+                execution advanced the counters by, least recently used
+                first.
+            hits: The number of entries whose key was cached.
+            misses: The number of entries whose key was not cached.
+            evictions: The number of keys evicted from the cache.
+
+        Private instance variables:
+            _loop: The summarized Loop instance.
+    """
+
+    def __init__(self, loop: 'bnf_grammar.Loop') -> None:
+        self._loop = loop
+        self.pure = True
+        self.reads = []
+        self.writes = []
+        self.cache = collections.OrderedDict()
+        self.hits = 0
+        self.misses = 0
+        self.evictions = 0
+        loop.summarize(self, frozenset())
+
+    def use(self, node: 'bnf_grammar.Exp | bnf_grammar.Cond',
+            assigned: frozenset['bnf_grammar.Id']) -> None:
+        """Add the Ids an expression reads before assignment to the reads.
+
+        Args:
+            node: The Exp or Cond instance that is evaluated.
+            assigned: The set of Id instances assigned on every path
+                from the loop entry to the node.
+        """
+        names = _Reads()
+        node.compile(names)
+        for identifier in names:
+            if identifier not in assigned and identifier not in self.reads:
+                self.reads += [identifier]
+
+    def define(self, identifier: 'bnf_grammar.Id',
+               assigned: frozenset['bnf_grammar.Id']
+               ) -> frozenset['bnf_grammar.Id']:
+        """Add an assigned Id to the writes.
+
+        Args:
+            identifier: The Id instance assigned.
+            assigned: The set of Id instances assigned on every path
+                from the loop entry to the assignment.
+
+        Returns:
+            The set of Id instances assigned on every path from the
+            loop entry to the end of the assignment.
+        """
+        if identifier not in self.writes:
+            self.writes += [identifier]
+        return assigned | {identifier}
+
+    def perform_io(self) -> None:
+        """Mark the loop impure because it reads or writes data."""
+        self.pure = False
+
+    def get_line(self) -> int:
+        """Return the line whereat the summarized loop appears."""
+        return self._loop.get_line()
+
+class MemoizingEngine:
+    """An execution engine that memoizes pure loops by their entry state.
+
+    Impure loops, and pure loops whose entry state is not cached, are
+    executed by an inner engine, if one is given, or by the tree-walk.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            execute_loop
+            dump_stats
+
+        Private instance methods:
+            _run
+
+        Private instance variables:
+            _inner: The engine that executes loops that are not
+                restored from a cache, or None for the tree-walk.
+            _capacity: The number of keys each cache holds at most.
+            _summaries: a dict whose keys are Loop instances and whose
+                values are their LoopSummary instances.
+    """
+
+    def __init__(self, inner: object = None,
+                 capacity: int = DEFAULT_CAPACITY) -> None:
+        self._inner = inner
+        self._capacity = capacity
+        self._summaries = {}
+
+    def _run(self, loop: 'bnf_grammar.Loop', data: TextIO) -> None:
+        """Execute a loop with the inner engine or the tree-walk."""
+        if self._inner:
+            self._inner.execute_loop(loop, data)
+        else:
+            condition, line = loop.get_condition(), loop.get_line()
+            stmt_seq = loop.get_stmt_seq()
+            header = loop.watch()
+            while condition.evaluate(data, line):
+                if header:
+                    header(data)
+                stmt_seq.execute(data)
+
+    def execute_loop(self, loop: 'bnf_grammar.Loop', data: TextIO) -> None:
+        """Execute a <loop> node, or restore its effects from its cache.
+
+        An identifier of the write set that is not in the read set and
+        ends an execution with the state it entered with may or may not
+        have been assigned by it. Its state is kept with the cache
+        entry, and the entry only applies while the identifier is in
+        that state on entry.
+
+        Args:
+            loop: The Loop instance to execute.
+            data: A datafile.DataFile or prefetch.PrefetchingDataFile
+                instance, whose next_value() method returns the next
+                input value for a "read" statement in the Core program,
+                and whose fail() method reports why there is none.
+        """
+        summary = self._summaries.get(loop)
+        if not summary:
+            summary = self._summaries[loop] = LoopSummary(loop)
+        if not summary.pure or not self._capacity:
+            self._run(loop, data)
+            return
+        key = tuple(identifier.save() for identifier in summary.reads)
+        cached = summary.cache.get(key)
+        if (cached and all(identifier.save() == saved
+                           for identifier, saved in cached[1])
+                and _charge(cached[2], data, loop.get_line())):
+            summary.cache.move_to_end(key)
+            summary.hits += 1
+            for identifier, saved in cached[0]:
+                identifier.restore(saved)
+            return
+        summary.misses += 1
+        entry_state = {identifier: identifier.save()
+                       for identifier in summary.writes
+                       if identifier not in summary.reads}
+        before = _snapshot()
+        self._run(loop, data)
+        counts = _since(before)
+        exit_state, unchanged = [], []
+        for identifier in summary.writes:
+            saved = identifier.save()
+            if entry_state.get(identifier) == saved:
+                unchanged += [(identifier, saved)]
+            elif saved[0]:
+                exit_state += [(identifier, saved)]
+        summary.cache[key] = tuple(exit_state), tuple(unchanged), counts
+        summary.cache.move_to_end(key)
+        if len(summary.cache) > self._capacity:
+            summary.cache.popitem(last = False)
+            summary.evictions += 1
+
+    def dump_stats(self, file: TextIO = sys.stderr) -> None:
+        """Print the summary and cache counters of every executed loop.
+
+        Args:
+            file: The text stream to print the counters to.
+        """
+        print('Loop summarization cache statistics (capacity: {0})'
+              .format(self._capacity), file = file)
+        for summary in sorted(self._summaries.values(),
+                              key = lambda summary: summary.get_line()):
+            if not summary.pure:
+                print('  loop at line {0}: impure'
+                      .format(summary.get_line()), file = file)
+                continue
+            print('  loop at line {0}: pure, reads {{{1}}}, writes {{{2}}}'
+                  .format(summary.get_line(),
+                          ', '.join(identifier.get_name()
+                                    for identifier in summary.reads),
+                          ', '.join(identifier.get_name()
+                                    for identifier in summary.writes)),
+                  file = file)
+            print('    {0} hit(s), {1} miss(es), {2} eviction(s)'
+                  .format(summary.hits, summary.misses, summary.evictions),
+                  file = file)
+        if self._inner:
+            self._inner.dump_stats(file)
@@ -0,0 +1,267 @@
+"""This module provides the memory report of the Core interpreter.
+
+An instance of the MemoryReport class traces the memory allocated by
+the Core interpreter with the tracemalloc module, and its report method
+prints three tables: the blocks and bytes that each phase (tokenize,
+parse, print, and execute, or specialize in the mode that replaces
+execute) left allocated and the peak it reached, the number of nodes of
+every class of the APT and their bytes, along with the depth of the
+APT, and the blocks and bytes that the statements of every line of the
+Core program left allocated and the peak they reached.
+
+The tokenizer is interleaved with the parser, so the allocations of the
+parse phase made by the core module are attributed to tokenize. The
+bytes of a node are the size of the node, as given by sys.getsizeof(),
+plus that of the lists, tuples, and strings among its instance
+variables; its children are counted as nodes of their own.
+
+Every statement executed by the tree-walk is reported through the enter
+and leave methods, which the execute method of the Stmt class of the
+bnf_grammar module calls. The memory allocated between two such calls
+is attributed to the innermost statement being executed, so that a
+statement is not charged for the statements nested in it, and a loop
+compiled by an engine of the jit module is charged to the statement
+that entered it. The code compiled by those engines counts its
+statements in locals, as it does for the line profiler, which are added
+to the counts of their lines when it returns, so the counts are the
+same in every engine. The report is the memory hook of the Prog class
+of the bnf_grammar module, which costs nothing when it is not assigned,
+as the instrument function there describes. Tracing slows down the
+whole run, so the report is meant for sizing rather than for timing.
+"""
+
+import collections
+import contextlib
+import gc
+import sys
+import tracemalloc
+from typing import Iterator, TextIO
+
+import metrics
+
+class MemoryReport:
+    """The memory allocated by the phases and statements of a run.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            start
+            stop
+            phase
+            census
+            enter
+            leave
+            emit
+            wrap
+            report
+
+        Private instance methods:
+            _snapshot
+            _charge
+
+        Public instance variables:
+            phases: a dict whose keys are the names of the phases
+                entered and whose values are lists of the blocks and
+                bytes left allocated by the phase and the peak bytes
+                allocated during it.
+            classes: a dict whose keys are the names of the classes of
+                the APT and whose values are lists of the number of
+                their nodes and their bytes.
+            depth: the depth of the APT, the root being at depth 1.
+            statements: a dict whose keys are line numbers and whose
+                values are the numbers of statements starting on the
+                line that the tree-walk executed.
+            compiled: a dict like statements of the statements executed
+                by compiled code.
+            lines: a dict whose keys are line numbers and whose values
+                are lists of the blocks and bytes left allocated by the
+                statements of the line and the most bytes that one of
+                them allocated above the bytes it started with.
+
+        Private instance variables:
+            _stack: the lines of the statements being executed, the
+                innermost last.
+            _blocks: the number of blocks allocated at the last call of
+                enter() or leave().
+            _bytes: the number of bytes traced at that call.
+    """
+
+    def __init__(self) -> None:
+        self.phases = {}
+        self.classes = collections.defaultdict(lambda: [0, 0])
+        self.depth = 0
+        self.statements = collections.defaultdict(int)
+        self.compiled = collections.defaultdict(int)
+        self.lines = collections.defaultdict(lambda: [0, 0, 0])
+        self._stack = []
+        self._blocks = self._bytes = 0
+
+    def start(self) -> None:
+        """Start tracing the allocations of the Core interpreter."""
+        tracemalloc.start()
+
+    def stop(self) -> None:
+        """Stop tracing, and free the traces."""
+        tracemalloc.stop()
+
+    def _snapshot(self) -> tracemalloc.Snapshot:
+        """Return the allocations traced, less those of the tracing."""
+        return tracemalloc.take_snapshot().filter_traces((
+            tracemalloc.Filter(False, tracemalloc.__file__),
+            tracemalloc.Filter(False, __file__)))
+
+    @contextlib.contextmanager
+    def phase(self, name: str) -> Iterator[None]:
+        """Account for the allocations of a phase.
+
+        The allocations that the core module makes during the parse
+        phase are accounted for in the tokenize phase.
+        """
+        before = self._snapshot()
+        floor = tracemalloc.get_traced_memory()[0]
+        tracemalloc.reset_peak()
+        try:
+            yield
+        finally:
+            peak = tracemalloc.get_traced_memory()[1] - floor
+            for statistic in self._snapshot().compare_to(before, 'filename'):
+                tokenizing = (name == 'parse' and statistic.traceback[0]
+                              .filename.endswith('core.py'))
+                totals = self.phases.setdefault(
+                    'tokenize' if tokenizing else name, [0, 0, 0])
+                totals[0] += statistic.count_diff
+                totals[1] += statistic.size_diff
+            self.phases.setdefault(name, [0, 0, 0])[2] = max(peak, 0)
+
+    def census(self, root: object) -> None:
+        """Count the nodes and bytes of every class of the APT, and its depth.
+
+        Args:
+            root: The root node of the APT.
+        """
+        seen, stack = {id(root)}, [(root, 1)]
+        while stack:
+            node, depth = stack.pop()
+            self.depth = max(self.depth, depth)
+            size = sys.getsizeof(node)
+            for value in gc.get_referents(node):
+                if isinstance(value, (list, tuple, str)):
+                    size += sys.getsizeof(value)
+            totals = self.classes[type(node).__name__]
+            totals[0] += 1
+            totals[1] += size
+            for child in metrics.children(node):
+                if id(child) not in seen:
+                    seen.add(id(child))
+                    stack.append((child, depth + 1))
+
+    def _charge(self) -> None:
+        """Charge the innermost statement with the memory since last called."""
+        current, peak = tracemalloc.get_traced_memory()
+        blocks = sys.getallocatedblocks()
+        if self._stack:
+            totals = self.lines[self._stack[-1]]
+            totals[0] += blocks - self._blocks
+            totals[1] += current - self._bytes
+            totals[2] = max(totals[2], peak - self._bytes)
+        tracemalloc.reset_peak()
+        self._blocks, self._bytes = blocks, current
+
+    def enter(self, line: int) -> None:
+        """Report the start of a statement executed by the tree-walk.
+
+        Args:
+            line: The line that the statement starts on.
+        """
+        self._charge()
+        self.statements[line] += 1
+        self._stack.append(line)
+
+    def leave(self) -> None:
+        """Report the end of the innermost statement being executed."""
+        self._charge()
+        self._stack.pop()
+
+    def emit(self, namespace: dict, line: int) -> str:
+        """Return the Python source that counts a compiled statement.
+
+        The statement is counted in a local of the compiled function,
+        which is added to the counts when wrap() has been applied.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, in which the line is noted.
+            line: The line that the statement starts on.
+        """
+        namespace.setdefault('m_lines', set()).add(line)
+        return 'm_{0} += 1'.format(line)
+
+    def wrap(self, source: list[str], namespace: dict) -> list[str]:
+        """Add the counts of a compiled function to the report.
+
+        The locals that emit() counts in are set to 0 on entry, and
+        added to the counts however the function returns.
+
+        Args:
+            source: The lines of the Python source of the function,
+                the first of which is its "def" statement.
+            namespace: The dict of the global names of the function,
+                to which the counts are added.
+
+        Returns:
+            The lines of the wrapped function.
+        """
+        lines = sorted(namespace.get('m_lines', ()))
+        if not lines:
+            return source
+        namespace['m_compiled'] = self.compiled
+        return ([source[0], '    {0} = 0'.format(
+                     ' = '.join('m_{0}'.format(line) for line in lines)),
+                 '    try:']
+                + ['    ' + line for line in source[1:]]
+                + ['    finally:']
+                + ['        m_compiled[{0}] += m_{0}'.format(line)
+                   for line in lines])
+
+    def report(self, source: list[str], file: TextIO = sys.stderr) -> None:
+        """Print the phases, the classes of the APT, and the lines.
+
+        The classes are printed with the most bytes first, and so are
+        the lines, by the bytes they left allocated.
+
+        Args:
+            source: The lines of the Core program.
+            file: The text stream to print to.
+        """
+        print('{0:<12}  {1:>10}  {2:>12}  {3:>12}'.format(
+                  'Phase', 'Blocks', 'Bytes', 'Peak bytes'), file = file)
+        for name in metrics.PHASES:
+            if name in self.phases:
+                print('{0:<12}  {1:>10}  {2:>12}  {3:>12}'.format(
+                          name, *self.phases[name]), file = file)
+        if self.classes:
+            print('\n{0:<12}  {1:>10}  {2:>12}  {3:>10}'.format(
+                      'Class', 'Nodes', 'Bytes', 'Bytes/node'), file = file)
+            for name, (nodes, size) in sorted(
+                    self.classes.items(),
+                    key = lambda item: (-item[1][1], item[0])):
+                print('{0:<12}  {1:>10}  {2:>12}  {3:>10.1f}'.format(
+                          name, nodes, size, size / nodes), file = file)
+            print('Total: {0} nodes, {1} bytes, depth {2}'.format(
+                      sum(nodes for nodes, _ in self.classes.values()),
+                      sum(size for _, size in self.classes.values()),
+                      self.depth), file = file)
+        if self.statements:
+            counts = {line: self.statements[line] + self.compiled[line]
+                      for line in set(self.statements) | set(self.compiled)}
+            print('\n{0:>6}  {1:>12}  {2:>10}  {3:>12}  {4:>12}  '
+                  '{5:>11}  Source'.format('Line', 'Statements', 'Blocks',
+                                           'Bytes', 'Peak bytes',
+                                           'Bytes/stmt'), file = file)
+            for line in sorted(counts, key = lambda line: (
+                                   -self.lines[line][1], line)):
+                text = source[line - 1].strip() if line <= len(source) else ''
+                blocks, size, peak = self.lines[line]
+                print('{0:>6}  {1:>12}  {2:>10}  {3:>12}  {4:>12}  {5:>11.1f}'
+                      '  {6}'.format(line, counts[line], blocks, size, peak,
+                                     size / counts[line], text), file = file)
@@ -0,0 +1,240 @@
+"""This module provides the phase metrics of the Core interpreter.
+
+An instance of the Metrics class records the wall-clock and CPU time
+that the Core interpreter spends in each of its phases (tokenize,
+parse, print, and execute, or specialize and format in the modes that
+replace them), and counts the tokens of the Core program, the nodes of
+its APT, and the statements executed and values read and written while
+it runs. The dump method writes the metrics, along with the peak
+resident set size of the process, as a JSON object or in the text
+exposition format of Prometheus.
+
+The tokenizer is interleaved with the parser, which asks it for a new
+line of the Core program whenever it runs out of tokens. An instance of
+the TimedTokenizer subclass of the Tokenizer class of the core module
+times every line it tokenizes and counts its tokens, and the time spent
+tokenizing during any other phase is attributed to tokenize instead.
+
+The counters of the execution are incremented by the APT classes of
+the bnf_grammar module, and by the code compiled by the engines of the
+jit module, through the metrics hook of the Prog class of that module,
+as the instrument function there describes.
+"""
+
+import contextlib
+import gc
+import json
+import sys
+import time
+from typing import Iterator
+
+import bnf_grammar
+import core
+
+try:
+    import resource
+except ImportError:
+    resource = None
+
+PHASES = ('tokenize', 'parse', 'print', 'format', 'specialize', 'execute')
+
+class Metrics:
+    """The times of the phases of a run and its counters.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            phase
+            add_tokens
+            count_nodes
+            emit
+            dump
+
+        Private instance methods:
+            _report
+            _prometheus
+
+        Public instance variables:
+            tokens: The number of tokens in the Core program.
+            nodes: The number of nodes in the APT.
+            statements: The number of statements executed.
+            reads: The number of values read by "read" statements.
+            writes: The number of values written by "write" statements.
+
+        Private instance variables:
+            _wall: a dict whose keys are the names of the phases entered
+                and whose values are their wall-clock times in seconds.
+            _cpu: a dict like _wall of the CPU times of the phases.
+    """
+
+    def __init__(self) -> None:
+        self.tokens = self.nodes = 0
+        self.statements = self.reads = self.writes = 0
+        self._wall, self._cpu = {}, {}
+
+    @contextlib.contextmanager
+    def phase(self, name: str) -> Iterator[None]:
+        """Time a phase, less the time spent tokenizing during it."""
+        wall, cpu = time.perf_counter(), time.process_time()
+        tokenize = self._wall.get('tokenize', 0), self._cpu.get('tokenize', 0)
+        try:
+            yield
+        finally:
+            wall = (time.perf_counter() - wall
+                    - (self._wall.get('tokenize', 0) - tokenize[0]))
+            cpu = (time.process_time() - cpu
+                   - (self._cpu.get('tokenize', 0) - tokenize[1]))
+            self._wall[name] = self._wall.get(name, 0) + wall
+            self._cpu[name] = self._cpu.get(name, 0) + cpu
+
+    def add_tokens(self, count: int, wall: float, cpu: float) -> None:
+        """Count the tokens of a line and the time taken to find them."""
+        self.tokens += count
+        self._wall['tokenize'] = self._wall.get('tokenize', 0) + wall
+        self._cpu['tokenize'] = self._cpu.get('tokenize', 0) + cpu
+
+    def count_nodes(self, root: object) -> None:
+        """Count the distinct nodes of the APT under a root node."""
+        self.nodes = sum(1 for _ in walk(root))
+
+    def emit(self, namespace: dict) -> str:
+        """Return the Python source that counts a compiled statement.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, to which this instance is added.
+        """
+        namespace['m_metrics'] = self
+        return 'm_metrics.statements += 1'
+
+    def _report(self) -> dict:
+        """Return the metrics as a dict in the layout of the JSON format."""
+        peak = None
+        if resource:
+            peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+            peak *= 1 if sys.platform == 'darwin' else 1024
+        return {
+            'phases': {name: {'wall_seconds': self._wall[name],
+                              'cpu_seconds': self._cpu[name]}
+                       for name in PHASES if name in self._wall},
+            'tokens': self.tokens,
+            'ast_nodes': self.nodes,
+            'statements_executed': self.statements,
+            'values_read': self.reads,
+            'values_written': self.writes,
+            'peak_rss_bytes': peak
+        }
+
+    def _prometheus(self, report: dict) -> str:
+        """Return a report in the Prometheus text exposition format."""
+        lines = []
+        for kind, help_text in (('wall', 'Wall-clock time'),
+                                ('cpu', 'CPU time')):
+            metric = 'core_phase_{0}_seconds'.format(kind)
+            lines += ['# HELP {0} {1} spent in a phase of the Core '
+                      'interpreter.'.format(metric, help_text),
+                      '# TYPE {0} gauge'.format(metric)]
+            lines += ['{0}{{phase="{1}"}} {2!r}'.format(
+                          metric, name, times[kind + '_seconds'])
+                      for name, times in report['phases'].items()]
+        for key, metric, kind, help_text in (
+                ('tokens', 'core_tokens', 'gauge',
+                 'Tokens in the Core program.'),
+                ('ast_nodes', 'core_ast_nodes', 'gauge',
+                 'Nodes in the abstract parse tree.'),
+                ('statements_executed', 'core_statements_executed_total',
+                 'counter', 'Statements executed.'),
+                ('values_read', 'core_values_read_total', 'counter',
+                 'Values read by "read" statements.'),
+                ('values_written', 'core_values_written_total', 'counter',
+                 'Values written by "write" statements.'),
+                ('peak_rss_bytes', 'core_peak_rss_bytes', 'gauge',
+                 'Peak resident set size of the process.')):
+            if report[key] is not None:
+                lines += ['# HELP {0} {1}'.format(metric, help_text),
+                          '# TYPE {0} {1}'.format(metric, kind),
+                          '{0} {1}'.format(metric, report[key])]
+        return '\n'.join(lines) + '\n'
+
+    def dump(self, path: str, form: str = 'json') -> None:
+        """Write the metrics to a file.
+
+        Args:
+            path: The path of the file.
+            form: "json" or "prometheus".
+        """
+        report = self._report()
+        with open(path, 'w') as file:
+            if form == 'prometheus':
+                file.write(self._prometheus(report))
+            else:
+                json.dump(report, file, indent = 2)
+                file.write('\n')
+
+class TimedTokenizer(core.Tokenizer):
+    """A tokenizer that reports its tokens and time to a Metrics instance.
+
+    Attributes:
+        Private instance variables:
+            _metrics: The Metrics instance reported to.
+            _depth: the number of nested calls of _tokenize_line(),
+                which recurses over lines of white space.
+    """
+
+    def __init__(self, filename: str, metrics: Metrics) -> None:
+        self._metrics = metrics
+        self._depth = 0
+        super().__init__(filename)
+
+    def _tokenize_line(self) -> None:
+        self._depth += 1
+        if self._depth > 1:
+            super()._tokenize_line()
+        else:
+            wall, cpu = time.perf_counter(), time.process_time()
+            super()._tokenize_line()
+            self._metrics.add_tokens(
+                sum(1 for token in self._tokens
+                    if token <= core.enums.Token.IDENTIFIER.value),
+                time.perf_counter() - wall, time.process_time() - cpu)
+        self._depth -= 1
+
+def children(node: object) -> list[object]:
+    """Return the children of an APT node, in the order of its variables.
+
+    The children of a node are the instances of the classes of the
+    bnf_grammar module among its instance variables, including those in
+    lists and tuples.
+
+    The instance variables are found with gc.get_referents() rather than
+    vars(), which would give the node a dict of its own instead of the
+    values laid out inline, and slow down every attribute access of the
+    node for the rest of the run.
+    """
+    variables = []
+    for value in gc.get_referents(node):
+        variables.extend(value.values() if isinstance(value, dict)
+                         else (value,))
+    found = []
+    for value in variables:
+        values = value if isinstance(value, (list, tuple)) else (value,)
+        found.extend(child for child in values
+                     if type(child).__module__ == bnf_grammar.__name__)
+    return found
+
+def walk(root: object) -> Iterator[object]:
+    """Yield every distinct APT node under a root node, once each.
+
+    Nodes are yielded in preorder, and the children of a node, as given
+    by children(), in the order of its instance variables.
+    """
+    seen, stack = {id(root)}, [root]
+    while stack:
+        node = stack.pop()
+        yield node
+        found = []
+        for child in children(node):
+            if id(child) not in seen:
+                seen.add(id(child))
+                found.append(child)
+        stack.extend(reversed(found))
@@ -0,0 +1,153 @@
+"""This module provides the output pipeline of the Core interpreter.
+
+An instance of a subclass of the Output class receives the values that
+"write" statements print when it is assigned to the output attribute
+of the Prog class of the bnf_grammar module. Every <id list> of a
+"write" statement precomputes the "NAME = " prefix of each of its
+identifiers, and the output formats a value after it and appends the
+result to a buffer. A resource governor is charged with the length of
+the text that the output formats, before it is appended. Values are
+formatted in decimal by the to_decimal function of the digits module,
+which converts ints of any size in subquadratic time, or, if the
+output is constructed with base 16 or 2, in hexadecimal or binary. The
+buffer is written to its sink in one call once it holds
+DEFAULT_THRESHOLD characters, when the execution of the Core program
+ends, and before a runtime error is reported, so that the output
+precedes the message.
+
+The sinks are:
+    TextOutput      the format of the Core interpreter, including the
+                    header that precedes the first "write" statement,
+                    on stdout or in a file
+    JsonLinesOutput one JSON object per value, holding the name of the
+                    identifier, the value, and the line of the "write"
+                    statement
+    NullOutput      nothing, for benchmarking the execution alone
+"""
+
+import json
+import sys
+from typing import TextIO
+
+import digits
+
+DEFAULT_THRESHOLD = 1 << 16
+HEADER = '\n----------Program Output----------\n'
+
+class Output:
+    """A buffer of formatted values in front of a text stream.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            header
+            format
+            append
+            write
+            flush
+            close
+
+        Private instance variables:
+            _stream: The text stream that the buffer is written to, or
+                None.
+            _base: The base that values are written in: 10, 16, or 2.
+            _threshold: The number of buffered characters at which the
+                buffer is written to the stream.
+            _parts: a list of the buffered strings.
+            _size: the number of buffered characters.
+    """
+
+    def __init__(self, stream: TextIO | None = sys.stdout,
+                 threshold: int = DEFAULT_THRESHOLD, base: int = 10) -> None:
+        self._stream = stream
+        self._base = base
+        self._threshold = threshold
+        self._parts = []
+        self._size = 0
+
+    def header(self) -> str:
+        """Return the text that precedes the first value written."""
+        return ''
+
+    def format(self, prefix: str, value: int, line: int) -> str:
+        """Return the text that a value is written as.
+
+        Args:
+            prefix: The "NAME = " prefix of the identifier written.
+            value: The value of the identifier.
+            line: The line whereat the "write" statement appears in the
+                Core program.
+        """
+        raise NotImplementedError
+
+    def append(self, text: str) -> None:
+        """Buffer text, and write the buffer once it is large enough."""
+        self._parts.append(text)
+        self._size += len(text)
+        if self._size >= self._threshold:
+            self.flush()
+
+    def write(self, prefix: str, value: int, line: int) -> None:
+        """Format a value, and buffer it.
+
+        Args:
+            prefix: The "NAME = " prefix of the identifier written.
+            value: The value of the identifier.
+            line: The line whereat the "write" statement appears in the
+                Core program.
+        """
+        self.append(self.format(prefix, value, line))
+
+    def flush(self) -> None:
+        """Write the buffer to the stream."""
+        if self._parts:
+            self._stream.write(''.join(self._parts))
+            self._parts, self._size = [], 0
+        if self._stream:
+            self._stream.flush()
+
+    def close(self) -> None:
+        """Flush the buffer, and close the stream unless it is stdout."""
+        self.flush()
+        if self._stream and self._stream is not sys.stdout:
+            self._stream.close()
+
+class TextOutput(Output):
+    """The output format of the Core interpreter."""
+
+    def header(self) -> str:
+        return HEADER
+
+    def format(self, prefix: str, value: int, line: int) -> str:
+        if self._base == 10 and -digits.SMALL < value < digits.SMALL:
+            return '{0}{1}\n'.format(prefix, value)
+        return '{0}{1}\n'.format(prefix, digits.to_base(value, self._base))
+
+class JsonLinesOutput(Output):
+    """One JSON object per value written.
+
+    Values in base 16 or 2 are written as JSON strings, and decimal
+    values as JSON numbers.
+    """
+
+    def format(self, prefix: str, value: int, line: int) -> str:
+        text = digits.to_base(value, self._base)
+        if self._base != 10:
+            text = '"{0}"'.format(text)
+        return '{{"name": {0}, "value": {1}, "line": {2}}}\n'.format(
+            json.dumps(prefix[:-3]), text, line)
+
+class NullOutput(Output):
+    """An output that discards every value."""
+
+    def __init__(self) -> None:
+        super().__init__(None)
+
+    def format(self, prefix: str, value: int, line: int) -> str:
+        return ''
+
+    def append(self, text: str) -> None:
+        pass
+
+    def write(self, prefix: str, value: int, line: int) -> None:
+        pass
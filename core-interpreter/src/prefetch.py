@@ -0,0 +1,228 @@
+"""This module provides the prefetching data reader of the Core interpreter.
+
+An instance of the PrefetchingDataFile class stands in for the DataFile
+class of the datafile module, which reads and converts the whole data
+file before the Core program starts. It starts a background thread
+instead, which reads the data file in chunks of at most CHUNK_SIZE
+bytes, converts the complete lines of every chunk to ints, and puts
+them in a queue ahead of the "read" statements of the Core program.
+The queue holds at most DEFAULT_DEPTH chunks, so the memory used stays
+bounded however large the data file is: the thread waits once the
+queue is full until the program catches up, and the program only waits
+for the data file once it has overtaken the thread.
+
+A chunk is whatever one read of the file returns, so a pipe or FIFO
+yields its lines as soon as they are written rather than once a chunk
+is full, and a slow file system is read while the program executes.
+The thread releases the GIL while it waits for the file.
+
+next_value chains the queued chunks with C iterators, so that a "read"
+statement enters no Python frame except once per chunk. The thread
+stops at the first empty or invalid line, or at the end of the file,
+and the fail method reports the same runtime errors as the DataFile
+class. An exception raised by the thread, such as an OSError while
+reading, is raised again by fail in the main thread.
+
+A binary data file needs no conversion, and its escapes follow its
+column, so the thread reads it whole and queues it as one chunk.
+"""
+
+import codecs
+import io
+import itertools
+import locale
+import queue
+import threading
+from typing import BinaryIO, Callable, NoReturn
+
+import bnf_grammar
+import datafile
+import digits
+
+CHUNK_SIZE = 1 << 16
+DEFAULT_DEPTH = 16
+JOIN_TIMEOUT = 1.0
+
+class PrefetchingDataFile:
+    """A data file whose integers are read ahead on a background thread.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            fail
+            close
+
+        Public instance variables:
+            name: The path of the data file.
+            next_value: The __next__ method of the iterator over the
+                queued values, which raises StopIteration once the
+                thread has stopped and its values have been read.
+
+        Private instance methods:
+            _prefetch
+            _read_head
+            _convert
+            _put
+            _drain
+
+        Private instance variables:
+            _file: The binary stream that the data file is read from.
+            _owned: Whether _file has been opened by this instance, and
+                is closed by the thread once it stops.
+            _queue: a bounded queue of lists or memoryviews of values,
+                ended by None.
+            _stop: the line at which the thread stopped, with its
+                newline if it has one, or None at the end of the file.
+            _error: the exception that stopped the thread, or None.
+            _closed: Whether the close method has been called.
+            _thread: The background thread.
+    """
+
+    def __init__(self, name: str, file: BinaryIO | None = None,
+                 depth: int = DEFAULT_DEPTH) -> None:
+        """Open the data file, and start reading it ahead.
+
+        Args:
+            name: The path of the data file, which is also the name
+                runtime errors report.
+            file: A binary stream to read instead of opening name, such
+                as a pipe.
+            depth: The number of chunks the queue holds at most.
+        """
+        self.name = name
+        self._owned = file is None
+        self._file = open(name, 'rb', buffering = 0) if file is None else file
+        self._queue = queue.Queue(max(depth, 1))
+        self._stop = None
+        self._error = None
+        self._closed = False
+        self.next_value = itertools.chain.from_iterable(
+            iter(self._queue.get, None)).__next__
+        self._thread = threading.Thread(target = self._prefetch,
+                                        daemon = True)
+        self._thread.start()
+
+    def _prefetch(self) -> None:
+        """Read and convert the data file until it stops or is closed."""
+        try:
+            read = getattr(self._file, 'read1', self._file.read)
+            chunk = self._read_head(read)
+            if chunk.startswith(datafile.MAGIC):
+                content = [chunk[len(datafile.MAGIC):]]
+                while chunk and not self._closed:
+                    chunk = read(CHUNK_SIZE)
+                    content.append(chunk)
+                self._put(datafile.decode_binary(b''.join(content),
+                                                 self.name))
+                return
+            decoder = io.IncrementalNewlineDecoder(
+                codecs.getincrementaldecoder(
+                    locale.getpreferredencoding(False))(), True)
+            parts = []
+            while True:
+                lines = decoder.decode(chunk, not chunk).split('\n')
+                tail = lines.pop()
+                if lines:
+                    lines[0] = ''.join(parts) + lines[0]
+                    parts = []
+                parts.append(tail)
+                if not self._convert(lines, True) or not chunk:
+                    break
+                chunk = read(CHUNK_SIZE)
+            tail = ''.join(parts)
+            if self._stop is None and tail:
+                self._convert([tail], False)
+        except BaseException as error:
+            self._error = error
+        finally:
+            self._put(None)
+            if self._owned:
+                self._file.close()
+
+    def _read_head(self, read: Callable[[int], bytes]) -> bytes:
+        """Read until the format of the data file can be told."""
+        chunk = read(CHUNK_SIZE)
+        while (chunk and len(chunk) < len(datafile.MAGIC)
+               and datafile.MAGIC.startswith(chunk)):
+            more = read(CHUNK_SIZE)
+            if not more:
+                break
+            chunk += more
+        return chunk
+
+    def _convert(self, lines: list[str], terminated: bool) -> bool:
+        """Queue the ints of lines up to the first empty or invalid one.
+
+        Args:
+            lines: The lines to convert, without their newlines.
+            terminated: Whether the last line ends with a newline.
+
+        Returns:
+            Whether every line holds an int and the thread is to go on.
+        """
+        try:
+            values = list(map(int, lines))
+        except ValueError:
+            values = []
+            for line in lines:
+                try:
+                    values.append(digits.from_decimal(line))
+                except ValueError:
+                    self._stop = line + '\n' if terminated else line
+                    break
+        if values and not self._put(values):
+            return False
+        return self._stop is None
+
+    def _put(self, item: list[int] | memoryview | None) -> bool:
+        """Queue an item unless the data file is closed.
+
+        Returns:
+            Whether the data file is still open.
+        """
+        if self._closed:
+            return False
+        self._queue.put(item)
+        return not self._closed
+
+    def fail(self) -> NoReturn:
+        """Report the line at which the thread stopped.
+
+        Raises:
+            SystemExit: Print a message to stderr that tells whether
+                the end of the data file has been reached or the line
+                is empty or does not contain an integer, and exit the
+                Python interpreter.
+            BaseException: The exception that stopped the thread.
+        """
+        if self._error:
+            self.close()
+            raise self._error
+        if self._stop is None:
+            bnf_grammar.runtime_error(self, 'input eof')
+        if self._stop == '\n':
+            bnf_grammar.runtime_error(self, 'input empty line')
+        bnf_grammar.runtime_error(self, 'input invalid line', self._stop)
+
+    def _drain(self) -> None:
+        """Remove every queued item."""
+        try:
+            while True:
+                self._queue.get_nowait()
+        except queue.Empty:
+            pass
+
+    def close(self) -> None:
+        """Stop reading ahead, drop the queued values, and join the thread.
+
+        The thread stops after its current read, and closes the data
+        file if it opened it. It is joined for JOIN_TIMEOUT seconds at
+        most, since a read of a pipe or FIFO that has not been written
+        to cannot be interrupted; such a thread is left to end with the
+        Python interpreter.
+        """
+        self._closed = True
+        self.next_value = iter(()).__next__
+        self._drain()
+        self._thread.join(JOIN_TIMEOUT)
+        self._drain()
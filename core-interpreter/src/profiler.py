@@ -0,0 +1,299 @@
+"""This module provides the line profiler of the Core interpreter.
+
+An instance of the LineProfiler class counts, for every line of a Core
+program, the statements that start on the line and are executed, and
+the iterations of the loops whose "while" is on the line, and estimates
+the time spent executing those statements, excluding the statements
+nested in them. The report method prints the lines sorted by that time,
+with their source.
+
+Every statement executed by the tree-walk calls the enter method when
+it starts and the leave method when it ends, from the instrumented
+"execute" method of the Stmt class of the bnf_grammar module. These
+calls cut the execution into stretches, each of which is spent in the
+innermost statement executing, and one stretch in every
+DEFAULT_INTERVAL on average is timed. The intervals between two timed
+stretches are drawn at random, so that the stretches of a loop whose
+body has as many of them as the interval are not all missed but one.
+The time of a line is the time of its timed stretches times the ratio
+of all stretches to the timed ones. The first stretch of every line is
+timed as well, and counted once, so that the lines executed once, such
+as that of an outer loop, are timed. A "while" or "if" statement is
+charged with the evaluations of its condition.
+
+A loop executed by an engine, such as those of the jit module, calls
+the enter_engine method before the engine and the leave method after
+it. The stretches between them that the tree-walk does not cut, which
+hold the compiled code, are all timed, and charged to the line of the
+loop as they are rather than scaled, since they are few and long. The
+times of the lines therefore add up to the time of the execution, and
+no share of it exceeds 100%.
+
+The code compiled by the engines of the jit module counts its
+statements and iterations in locals, which are added to the profile
+when it returns, without timing them, so the counts are the same in
+every engine. A loop skipped by the memo module is counted as the
+execution that it was cached from.
+
+The profiler is the profiler hook of the Prog class of the bnf_grammar
+module; see the instrument function there for what a run without it
+pays.
+"""
+
+import collections
+import random
+import sys
+import time
+from typing import Callable, TextIO
+
+DEFAULT_INTERVAL = 16
+
+class LineProfiler:
+    """The counts and sampled times of the lines of a Core program.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            start
+            stop
+            enter
+            enter_engine
+            leave
+            header
+            emit
+            emit_header
+            wrap
+            report
+
+        Private instance methods:
+            _draw
+            _tick
+
+        Public instance variables:
+            walked: a dict whose keys are line numbers and whose values
+                are the numbers of statements starting on the line that
+                the tree-walk executed.
+            compiled: a dict like walked of the statements executed by
+                compiled code.
+            iterations: a dict whose keys are the line numbers of loops
+                and whose values are the numbers of iterations of the
+                loops on the line.
+
+        Private instance variables:
+            _interval: The mean number of stretches per timed one.
+            _random: The random number generator of the intervals.
+            _countdown: the number of stretches until the next timed
+                one.
+            _stack: a list of the lines of the statements executing,
+                the innermost last, negated for a loop that an engine
+                executes.
+            _line: the line that the open timed stretch is charged to,
+                or 0 if no stretch is being timed.
+            _first: Whether the open timed stretch is the first of its
+                line.
+            _exact: Whether the open timed stretch is spent in an
+                engine.
+            _start: the time at which the open timed stretch started.
+            _stretches: the number of stretches, other than the first
+                of every line, that have started.
+            _sampled: the number of those stretches that were timed.
+            _times: a dict whose keys are line numbers and whose values
+                are the total times in seconds of the timed stretches
+                of the line, other than the first.
+            _firsts: a dict like _times of the first stretch of every
+                line.
+            _engines: a dict like _times of the stretches spent in an
+                engine, every one of which is timed.
+            _wall: the wall-clock time in seconds between start() and
+                stop().
+    """
+
+    def __init__(self, interval: int = DEFAULT_INTERVAL,
+                 seed: int | None = None) -> None:
+        self._interval = max(interval, 1)
+        self._random = random.Random(seed)
+        self._countdown = self._draw()
+        self.walked = collections.defaultdict(int)
+        self.compiled = collections.defaultdict(int)
+        self.iterations = collections.defaultdict(int)
+        self._stack = []
+        self._line = 0
+        self._first = False
+        self._exact = False
+        self._start = 0.0
+        self._stretches = 0
+        self._sampled = 0
+        self._times = collections.defaultdict(float)
+        self._firsts = {}
+        self._engines = collections.defaultdict(float)
+        self._wall = 0.0
+
+    def _draw(self) -> int:
+        """Return the number of stretches until the next timed one."""
+        return self._random.randint(1, 2 * self._interval - 1)
+
+    def start(self) -> None:
+        """Start the clock of the execution."""
+        self._wall = time.perf_counter()
+
+    def stop(self) -> None:
+        """Stop the clock of the execution, and the timed stretch."""
+        self._stack = []
+        self._tick()
+        self._wall = time.perf_counter() - self._wall
+
+    def _tick(self) -> None:
+        """End the timed stretch, if any, and time the next if drawn."""
+        if self._line:
+            elapsed = time.perf_counter() - self._start
+            if self._exact:
+                self._engines[self._line] += elapsed
+            elif self._first:
+                self._firsts[self._line] += elapsed
+            else:
+                self._times[self._line] += elapsed
+        line = self._stack[-1] if self._stack else 0
+        self._exact = line < 0
+        if self._exact:
+            self._line = -line
+            self._start = time.perf_counter()
+            return
+        self._first = bool(line) and line not in self._firsts
+        if self._first:
+            self._firsts[line] = 0.0
+        else:
+            self._stretches += 1
+            self._countdown -= 1
+            if self._countdown:
+                self._line = 0
+                return
+            self._countdown = self._draw()
+            self._sampled += 1
+        self._line = line
+        self._start = time.perf_counter()
+
+    def enter(self, line: int) -> None:
+        """Count a statement executed by the tree-walk as it starts.
+
+        Args:
+            line: The line that the statement starts on.
+        """
+        self.walked[line] += 1
+        self._stack.append(line)
+        self._tick()
+
+    def enter_engine(self, line: int) -> None:
+        """Time the stretches of a loop that an engine executes.
+
+        Args:
+            line: The line of the loop.
+        """
+        self._stack.append(-line)
+        self._tick()
+
+    def leave(self) -> None:
+        """Note that the innermost statement or engine has ended."""
+        self._stack.pop()
+        self._tick()
+
+    def header(self, line: int) -> Callable[[TextIO], None]:
+        """Return the count of the iterations of a loop in the tree-walk.
+
+        Args:
+            line: The line of the loop.
+
+        Returns:
+            A function of the data stream to call at every header of
+            the loop whose condition resolved to True.
+        """
+        iterations = self.iterations
+        def count(data: TextIO) -> None:
+            iterations[line] += 1
+        return count
+
+    def emit(self, namespace: dict, line: int) -> str:
+        """Return the Python source that counts a compiled statement.
+
+        The statement is counted in a local of the compiled function,
+        which is added to the counts when wrap() has been applied.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, in which the line is noted.
+            line: The line that the statement starts on.
+        """
+        namespace.setdefault('p_lines', set()).add(line)
+        return 'p_{0} += 1'.format(line)
+
+    def emit_header(self, namespace: dict, line: int) -> str:
+        """Return the Python source that counts a compiled iteration.
+
+        Args:
+            namespace: The dict of the global names of the compiled
+                function, in which the line is noted.
+            line: The line of the loop.
+        """
+        namespace.setdefault('q_lines', set()).add(line)
+        return 'q_{0} += 1'.format(line)
+
+    def wrap(self, source: list[str], namespace: dict) -> list[str]:
+        """Add the counts of a compiled function to the profile.
+
+        The locals that emit() and emit_header() count in are set to 0
+        on entry, and added to the counts however the function returns.
+
+        Args:
+            source: The lines of the Python source of the function,
+                the first of which is its "def" statement.
+            namespace: The dict of the global names of the function,
+                to which the counts are added.
+
+        Returns:
+            The lines of the wrapped function.
+        """
+        statements = sorted(namespace.get('p_lines', ()))
+        loops = sorted(namespace.get('q_lines', ()))
+        if not statements and not loops:
+            return source
+        namespace['p_compiled'] = self.compiled
+        namespace['p_iterations'] = self.iterations
+        counters = (['p_{0}'.format(line) for line in statements]
+                    + ['q_{0}'.format(line) for line in loops])
+        return ([source[0], '    {0} = 0'.format(' = '.join(counters)),
+                 '    try:']
+                + ['    ' + line for line in source[1:]]
+                + ['    finally:']
+                + ['        p_compiled[{0}] += p_{0}'.format(line)
+                   for line in statements]
+                + ['        p_iterations[{0}] += q_{0}'.format(line)
+                   for line in loops])
+
+    def report(self, source: list[str], file: TextIO = sys.stderr) -> None:
+        """Print the executed lines, the most time-consuming first.
+
+        Args:
+            source: The lines of the Core program.
+            file: The text stream to print to.
+        """
+        scale = self._stretches / self._sampled if self._sampled else 0
+        times = {line: min(self._firsts.get(line, 0)
+                           + self._times.get(line, 0) * scale
+                           + self._engines.get(line, 0), self._wall)
+                 for line in self.walked}
+        lines = set(self.walked) | set(self.compiled) | set(self.iterations)
+        print('{0:>6}  {1:>12}  {2:>12}  {3:>10}  {4:>6}  Source'.format(
+                  'Line', 'Statements', 'Iterations', 'Time (s)', '% Time'),
+              file = file)
+        for line in sorted(lines, key = lambda line: (-times.get(line, 0),
+                                                      line)):
+            text = source[line - 1].strip() if line <= len(source) else ''
+            share = (100 * times.get(line, 0) / self._wall
+                     if self._wall > 0 else 0)
+            print('{0:>6}  {1:>12}  {2:>12}  {3:>10.6f}  {4:>6.1f}  {5}'
+                  .format(line, self.walked[line] + self.compiled[line],
+                          self.iterations[line], times.get(line, 0), share,
+                          text), file = file)
+        print('Total execution time: {0:.6f} s, {1} stretches timed out '
+              'of {2}'.format(self._wall, self._sampled + len(self._firsts),
+                              self._stretches + len(self._firsts)),
+              file = file)
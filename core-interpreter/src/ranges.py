@@ -0,0 +1,303 @@
+"""This module provides the value-range analysis of the Core interpreter.
+
+An instance of the RangeAnalysis class abstractly interprets a parsed
+Core program: instead of integers, the identifiers take on intervals
+that contain every value they may hold at each program point. The
+"analyze", "refine" and "bounds" methods of the APT classes call the
+public methods of RangeAnalysis, which implement the transfer
+functions. Conditions narrow the intervals of the identifiers they
+compare. The header of a loop is iterated to a fixpoint, and intervals
+that keep growing on a back-edge are widened to infinity after
+WIDENING_DELAY iterations, followed by one narrowing pass. The values
+of "read" statements are unbounded unless the data file is declared
+to hold only values in a given range.
+
+The result is the interval of every identifier over the whole run.
+Identifiers whose interval fits in 64-bit signed integers are proven
+never to need unbounded integers, which lets the int64 mode of the
+tiered engine in the jit module hold them without overflow checks.
+"""
+
+import math
+import sys
+from typing import TextIO
+
+import bnf_grammar
+
+WIDENING_DELAY = 2
+INT64_MIN, INT64_MAX = -2 ** 63, 2 ** 63 - 1
+
+class Interval:
+    """A closed interval of integers whose bounds may be infinite.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            __add__
+            __sub__
+            __mul__
+            __eq__
+            join
+            widen
+            fits_int64
+            __str__
+
+        Public instance variables:
+            low: The lower bound, an integer or -math.inf.
+            high: The upper bound, an integer or math.inf.
+    """
+
+    def __init__(self, low: int | float = -math.inf,
+                 high: int | float = math.inf) -> None:
+        self.low = low
+        self.high = high
+
+    def __add__(self, other: 'Interval') -> 'Interval':
+        return Interval(self.low + other.low, self.high + other.high)
+
+    def __sub__(self, other: 'Interval') -> 'Interval':
+        return Interval(self.low - other.high, self.high - other.low)
+
+    def __mul__(self, other: 'Interval') -> 'Interval':
+        products = [_multiply(a, b) for a in (self.low, self.high)
+                    for b in (other.low, other.high)]
+        return Interval(min(products), max(products))
+
+    def __eq__(self, other: object) -> bool:
+        return (isinstance(other, Interval) and self.low == other.low
+                and self.high == other.high)
+
+    def join(self, other: 'Interval') -> 'Interval':
+        """Return the smallest interval containing both intervals."""
+        return Interval(min(self.low, other.low), max(self.high, other.high))
+
+    def widen(self, other: 'Interval') -> 'Interval':
+        """Return this interval with the bounds other exceeds at infinity."""
+        return Interval(self.low if other.low >= self.low else -math.inf,
+                        self.high if other.high <= self.high else math.inf)
+
+    def fits_int64(self) -> bool:
+        """Return whether every value of the interval fits in 64 bits."""
+        return INT64_MIN <= self.low and self.high <= INT64_MAX
+
+    def __str__(self) -> str:
+        return '[{0}, {1}]'.format(
+            '-inf' if self.low == -math.inf else self.low,
+            '+inf' if self.high == math.inf else self.high)
+
+def _multiply(a: int | float, b: int | float) -> int | float:
+    """Multiply two bounds, where zero times infinity is zero."""
+    if a == 0 or b == 0:
+        return 0
+    return a * b
+
+class RangeAnalysis:
+    """An abstract interpreter of Core over intervals.
+
+    A state is a dict whose keys are Id instances and whose values are
+    Interval instances, or None if the program point is unreachable. An
+    identifier that is missing from a state has not been initialized;
+    reading it ends the run, so it does not constrain joins.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            analyze
+            constant
+            lookup
+            add
+            subtract
+            multiply
+            assign
+            read
+            join
+            compare
+            loop
+            proven
+            dump_report
+
+        Private instance variables:
+            _data_range: The Interval of the values of "read"
+                statements.
+            _ranges: a dict whose keys are Id instances and whose
+                values are the Interval instances of every value they
+                are assigned.
+            _assignments: a dict whose keys are tuples of a line number
+                and an Id instance and whose values are the Interval
+                instances of the values assigned on that line.
+    """
+
+    def __init__(self, data_range: Interval | None = None) -> None:
+        self._data_range = data_range or Interval()
+        self._ranges = {}
+        self._assignments = {}
+
+    def analyze(self, program: 'bnf_grammar.Prog') -> None:
+        """Analyze a parsed Core program."""
+        program.analyze(self)
+
+    def constant(self, value: int) -> Interval:
+        """Return the interval of an integer literal."""
+        return Interval(value, value)
+
+    def lookup(self, state: dict, identifier: 'bnf_grammar.Id') -> Interval:
+        """Return the interval of an identifier in a state."""
+        return state.get(identifier, Interval())
+
+    def add(self, left: Interval, right: Interval) -> Interval:
+        """Return the interval of a sum."""
+        return left + right
+
+    def subtract(self, left: Interval, right: Interval) -> Interval:
+        """Return the interval of a difference."""
+        return left - right
+
+    def multiply(self, left: Interval, right: Interval) -> Interval:
+        """Return the interval of a product."""
+        return left * right
+
+    def assign(self, state: dict | None, identifier: 'bnf_grammar.Id',
+               interval: Interval, line: int) -> dict | None:
+        """Return the state after an assignment, and record it.
+
+        Args:
+            state: The state before the assignment.
+            identifier: The Id instance assigned.
+            interval: The interval of the assigned value.
+            line: The line whereat the assignment appears in the Core
+                program.
+        """
+        if state is None:
+            return None
+        key = (line, identifier)
+        if key in self._assignments:
+            self._assignments[key] = self._assignments[key].join(interval)
+        else:
+            self._assignments[key] = interval
+        if identifier in self._ranges:
+            self._ranges[identifier] = self._ranges[identifier].join(interval)
+        else:
+            self._ranges[identifier] = interval
+        return {**state, identifier: interval}
+
+    def read(self, state: dict | None, identifier: 'bnf_grammar.Id',
+             line: int) -> dict | None:
+        """Return the state after reading a value into an identifier."""
+        return self.assign(state, identifier, self._data_range, line)
+
+    def join(self, left: dict | None, right: dict | None) -> dict | None:
+        """Return the state that holds at the confluence of two paths."""
+        if left is None:
+            return right
+        if right is None:
+            return left
+        joined = {**left, **right}
+        for identifier in left.keys() & right.keys():
+            joined[identifier] = left[identifier].join(right[identifier])
+        return joined
+
+    def compare(self, state: dict | None,
+                left: 'bnf_grammar.Op', operator: str,
+                right: 'bnf_grammar.Op', outcome: bool) -> dict | None:
+        """Return a state narrowed by the outcome of a comparison.
+
+        Args:
+            state: The state before the comparison.
+            left: The left <op> node of the comparison.
+            operator: The name of the comparison operator.
+            right: The right <op> node of the comparison.
+            outcome: The Boolean that the comparison resolves to.
+
+        Returns:
+            The narrowed state, or None if the comparison cannot
+            resolve to outcome.
+        """
+        if state is None:
+            return None
+        if not outcome:
+            operator = {'EQUAL': 'NOT_EQUAL', 'NOT_EQUAL': 'EQUAL',
+                        'LESS_THAN': 'GREATER_THAN_OR_EQUAL',
+                        'GREATER_THAN_OR_EQUAL': 'LESS_THAN',
+                        'GREATER_THAN': 'LESS_THAN_OR_EQUAL',
+                        'LESS_THAN_OR_EQUAL': 'GREATER_THAN'}[operator]
+        a, b = left.bounds(self, state), right.bounds(self, state)
+        if operator == 'EQUAL':
+            a = b = Interval(max(a.low, b.low), min(a.high, b.high))
+        if operator == 'LESS_THAN':
+            a, b = (Interval(a.low, min(a.high, b.high - 1)),
+                    Interval(max(b.low, a.low + 1), b.high))
+        if operator == 'LESS_THAN_OR_EQUAL':
+            a, b = (Interval(a.low, min(a.high, b.high)),
+                    Interval(max(b.low, a.low), b.high))
+        if operator == 'GREATER_THAN':
+            b, a = (Interval(b.low, min(b.high, a.high - 1)),
+                    Interval(max(a.low, b.low + 1), a.high))
+        if operator == 'GREATER_THAN_OR_EQUAL':
+            b, a = (Interval(b.low, min(b.high, a.high)),
+                    Interval(max(a.low, b.low), a.high))
+        if a.low > a.high or b.low > b.high:
+            return None
+        state = dict(state)
+        for operand, interval in ((left, a), (right, b)):
+            if operand.get_id() and operand.get_id() in state:
+                state[operand.get_id()] = interval
+        return state
+
+    def loop(self, loop: 'bnf_grammar.Loop', state: dict | None
+             ) -> dict | None:
+        """Return the state after a loop by iterating its header.
+
+        The state at the header is the join of the entry state and the
+        state at the end of the body. After WIDENING_DELAY iterations,
+        the header is widened instead of joined until it is stable, and
+        one more iteration narrows it again.
+        """
+        condition, stmt_seq = loop.get_condition(), loop.get_stmt_seq()
+        header, iteration = state, 0
+        while header is not None:
+            body = stmt_seq.analyze(self, condition.refine(self, header,
+                                                           True))
+            following = self.join(state, body)
+            if iteration >= WIDENING_DELAY and following is not None:
+                following = {identifier: (header[identifier].widen(
+                                 interval) if identifier in header
+                                 else interval)
+                             for identifier, interval in following.items()}
+            if following == header:
+                break
+            header, iteration = following, iteration + 1
+        if header is not None:
+            narrowed = self.join(state, stmt_seq.analyze(
+                self, condition.refine(self, header, True)))
+            if narrowed is not None:
+                header = {identifier: (Interval(
+                              max(interval.low, narrowed[identifier].low),
+                              min(interval.high, narrowed[identifier].high))
+                              if identifier in narrowed else interval)
+                          for identifier, interval in header.items()}
+        return condition.refine(self, header, False)
+
+    def proven(self) -> set['bnf_grammar.Id']:
+        """Return the identifiers proven to fit in 64-bit integers."""
+        return {identifier for identifier, interval in self._ranges.items()
+                if interval.fits_int64()}
+
+    def dump_report(self, file: TextIO = sys.stderr) -> None:
+        """Print the interval of every identifier and assignment.
+
+        Args:
+            file: The text stream to print the report to.
+        """
+        print('Value-range analysis (read values in {0})'
+              .format(self._data_range), file = file)
+        for identifier, interval in sorted(
+                self._ranges.items(), key = lambda item: item[0].get_name()):
+            print('  {0}: {1}, {2}'.format(
+                identifier.get_name(), interval,
+                'fits in int64' if interval.fits_int64()
+                else 'may go bigint'), file = file)
+        for (line, identifier), interval in sorted(
+                self._assignments.items(),
+                key = lambda item: (item[0][0], item[0][1].get_name())):
+            print('  line {0}: {1} = {2}'.format(
+                line, identifier.get_name(), interval), file = file)
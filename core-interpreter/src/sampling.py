@@ -0,0 +1,169 @@
+"""This module provides the sampling profiler of the Core interpreter.
+
+An instance of the SamplingProfiler class interrupts the execution of a
+Core program every DEFAULT_INTERVAL seconds of CPU time, with a SIGPROF
+timer, and records the Core execution stack at which it was
+interrupted: the "while" and "if" statements that are executing, from
+the outermost in, followed by the statement being executed. The dump
+method writes the number of samples of every stack in the collapsed
+format of flame graph tools, with a frame per statement that holds its
+line number and the first line of its pretty-printed text:
+
+    program;6: while ( I < N );10: while ( J < 3 );10: J = J + 1 42
+
+The engines need not publish their position: every statement of the
+tree-walk executes in a frame of the plain or instrumented "execute"
+method of the Stmt class of the bnf_grammar module, or of its "record"
+method while a trace is recorded, whose "self" is the statement. The
+Python frames that the timer interrupts are therefore walked instead,
+which costs nothing between samples. A frame of a loop compiled by an
+engine of the jit module ends the stack with the name of the compiled
+code, such as "compiled loop at line 6", below the statement of the
+loop.
+
+On platforms without setitimer, or when the profiler is not started on
+the main thread, a sidecar thread samples the frames of the thread that
+started it every interval of wall-clock time instead, as often as it is
+given the GIL.
+"""
+
+import collections
+import contextlib
+import signal
+import sys
+import threading
+import types
+from typing import Iterator
+
+import bnf_grammar
+
+DEFAULT_INTERVAL = 0.001
+
+_STATEMENTS = frozenset((bnf_grammar.Stmt.plain_execute.__code__,
+                         bnf_grammar.Stmt.instrumented_execute.__code__,
+                         bnf_grammar.Stmt.record.__code__))
+
+class SamplingProfiler:
+    """The sampled Core execution stacks of a run.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            start
+            stop
+            dump
+
+        Private instance methods:
+            _handle
+            _watch
+            _sample
+            _label
+
+        Private instance variables:
+            _interval: The number of seconds between two samples.
+            _stacks: a dict whose keys are collapsed stacks and whose
+                values are their numbers of samples.
+            _labels: a dict whose keys are Stmt instances and whose
+                values are their frames in the collapsed stacks.
+            _handler: the signal handler of SIGPROF before start(), or
+                None if a thread samples.
+            _thread: the sidecar thread, or None if a timer samples.
+            _target: the identifier of the sampled thread.
+            _stopped: an Event that is set to stop the sidecar thread.
+            _busy: Whether a sample is being taken.
+    """
+
+    def __init__(self, interval: float = DEFAULT_INTERVAL) -> None:
+        self._interval = interval
+        self._stacks = collections.Counter()
+        self._labels = {}
+        self._handler = None
+        self._thread = None
+        self._target = None
+        self._stopped = threading.Event()
+        self._busy = False
+
+    def start(self) -> None:
+        """Start sampling the thread that calls this method."""
+        self._target = threading.get_ident()
+        if (hasattr(signal, 'setitimer')
+                and threading.current_thread() is threading.main_thread()):
+            self._handler = signal.signal(signal.SIGPROF, self._handle)
+            signal.setitimer(signal.ITIMER_PROF, self._interval,
+                             self._interval)
+        else:
+            self._stopped.clear()
+            self._thread = threading.Thread(target = self._watch,
+                                            daemon = True)
+            self._thread.start()
+
+    def stop(self) -> None:
+        """Stop sampling."""
+        if self._thread:
+            self._stopped.set()
+            self._thread.join()
+            self._thread = None
+        else:
+            signal.setitimer(signal.ITIMER_PROF, 0)
+            signal.signal(signal.SIGPROF, self._handler)
+            self._handler = None
+
+    def _handle(self, signum: int, frame: types.FrameType | None) -> None:
+        """Sample the frame that the timer interrupted.
+
+        A signal that interrupts the handler itself is not sampled.
+        """
+        if not self._busy:
+            self._busy = True
+            self._sample(frame)
+            self._busy = False
+
+    def _watch(self) -> None:
+        """Sample the frames of the target thread until stopped."""
+        while not self._stopped.wait(self._interval):
+            self._sample(sys._current_frames().get(self._target))
+
+    def _sample(self, frame: types.FrameType | None) -> None:
+        """Count the Core execution stack of an innermost frame."""
+        stack = []
+        while frame:
+            code = frame.f_code
+            if code in _STATEMENTS:
+                stack.append(self._label(frame.f_locals['self']))
+            elif code.co_filename.startswith(('<compiled loop',
+                                              '<trace of loop')):
+                stack.append(code.co_filename[1:-1])
+            frame = frame.f_back
+        stack.append('program')
+        self._stacks[';'.join(reversed(stack))] += 1
+
+    def _label(self, statement: 'bnf_grammar.Stmt') -> str:
+        """Return the frame of a statement in the collapsed stacks."""
+        label = self._labels.get(statement)
+        if label is None:
+            text = bnf_grammar.render(statement).strip().split('\n')[0]
+            label = '{0}: {1}'.format(statement.get_line(),
+                                      text.rstrip(';').replace(';', ','))
+            self._labels[statement] = label
+        return label
+
+    def dump(self, path: str) -> None:
+        """Write the collapsed stacks to a file, most sampled first.
+
+        Args:
+            path: The path of the file.
+        """
+        with open(path, 'w') as file:
+            for stack, count in self._stacks.most_common():
+                file.write('{0} {1}\n'.format(stack, count))
+
+@contextlib.contextmanager
+def sample(profiler: SamplingProfiler | None) -> Iterator[None]:
+    """Sample the execution of a block with a profiler, if there is one."""
+    if profiler:
+        profiler.start()
+    try:
+        yield
+    finally:
+        if profiler:
+            profiler.stop()
@@ -0,0 +1,528 @@
+"""This module provides the partial evaluator of the Core interpreter.
+
+An instance of the Specializer class symbolically executes a parsed
+Core program against what is known before it runs: the data file, if
+one is given, and the integer literals of the program. The "specialize"
+methods of the statement classes of the APT call the public methods of
+Specializer. Every identifier is either static, with a value known to
+the specializer, or dynamic. Statements whose identifiers are static
+are executed by the specializer; the others are emitted to a residual
+Core program in which the static identifiers that they read are
+replaced by their values.
+
+An <if> node whose condition is dynamic emits both branches, and the
+identifiers that differ between the branches become dynamic. A <loop>
+node whose condition is static is unrolled as long as its iterations
+fold away. A loop whose condition is dynamic, or an iteration of which
+leaves residual statements, is emitted whole: its body is specialized
+repeatedly, making every identifier whose value differs between the
+start and the end of the body dynamic, until the set of static
+identifiers is stable. Static identifiers that become dynamic are
+assigned their values in the residual program at the point where they
+do.
+
+Every statement and every unrolled iteration counts against a step
+budget. Once the budget is exhausted, every loop that is still to be
+unrolled is emitted instead, so that the specializer terminates even if
+the Core program does not. If nothing remains to be emitted but "write"
+statements, the program folds to its output.
+"""
+
+import io
+import sys
+from typing import Callable, TextIO
+
+import bnf_grammar
+import digits
+
+DEFAULT_BUDGET = 1000000
+DYNAMIC = object()
+
+class _Stop(Exception):
+    """Raised to end specialization at a statement that always fails."""
+
+class _Uninitialized(Exception):
+    """Raised when the value of an uninitialized identifier is used."""
+
+    def __init__(self, identifier: 'bnf_grammar.Id') -> None:
+        super().__init__(identifier.get_name())
+        self.identifier = identifier
+
+class _Unset:
+    """The stand-in for an uninitialized identifier in static code.
+
+    Any operation on an instance raises _Uninitialized, so a static
+    expression fails on the same identifier, and only if, the tree-walk
+    would evaluate it.
+    """
+
+    def __init__(self, identifier: 'bnf_grammar.Id') -> None:
+        self._identifier = identifier
+
+    def _fail(self, *args: object) -> None:
+        raise _Uninitialized(self._identifier)
+
+    __add__ = __radd__ = __sub__ = __rsub__ = __mul__ = __rmul__ = _fail
+    __eq__ = __ne__ = __lt__ = __gt__ = __le__ = __ge__ = _fail
+    __bool__ = _fail
+
+class _Names(dict):
+    """A dict that names a Python expression for each Id it is asked for."""
+
+    def __init__(self, name: Callable[['bnf_grammar.Id'], str]) -> None:
+        super().__init__()
+        self._name = name
+
+    def __missing__(self, identifier: 'bnf_grammar.Id') -> str:
+        self[identifier] = self._name(identifier)
+        return self[identifier]
+
+def _noop() -> str:
+    """Return a Core statement that has no effect."""
+    return 'if ( 0 != 0 ) then {0} = {0}; end;'.format(
+        bnf_grammar.Id.get_declared()[0].get_name())
+
+def literal(value: int) -> str:
+    """Return the Core expression whose value is an integer."""
+    if value >= 0:
+        return digits.to_decimal(value)
+    return '(0 - {0})'.format(digits.to_decimal(-value))
+
+class Specializer:
+    """A partial evaluator of Core programs.
+
+    Attributes:
+        Public instance methods:
+            __init__
+            specialize
+            assign
+            branch
+            loop
+            read
+            write
+            dump_stats
+            get_outputs
+            has_output
+            get_error
+            is_folded
+            get_residual
+
+        Private instance methods:
+            _evaluate
+            _function
+            _residual
+            _references
+            _emit
+            _materialize
+            _merge
+            _speculate
+            _fail
+
+        Private instance variables:
+            _data: The datafile.DataFile instance of the data file, or
+                None if the values read are unknown.
+            _budget: The number of steps after which loops are no
+                longer unrolled.
+            _steps: The number of steps taken.
+            _state: a dict whose keys are the initialized Id instances
+                and whose values are their values, or DYNAMIC.
+            _lines: the list of residual statements being emitted.
+            _depth: the indentation level of the next residual
+                statement.
+            _speculative: the number of enclosing <if> and <loop> nodes
+                whose conditions are dynamic.
+            _functions: a dict whose keys are <exp> and <cond> nodes
+                and whose values are tuples of their translation to a
+                Python function and the Id instances it takes.
+            _data_lines: the number of lines of the data file read.
+            _data_known: whether the position in the data file is known.
+            _outputs: a list of the lines written by static "write"
+                statements that are always executed.
+            _output: whether a "write" statement is always executed,
+                even if it fails, so that the output has its header.
+            _error: the message of the runtime error that the program
+                always ends with, or None.
+            _folded: whether only "write" statements have been emitted.
+            _residual_loops: the number of loops emitted.
+    """
+
+    def __init__(self, data: 'datafile.DataFile | None' = None,
+                 budget: int = DEFAULT_BUDGET) -> None:
+        self._data = data
+        self._budget = budget
+        self._steps = 0
+        self._state = {}
+        self._lines = []
+        self._depth = 1
+        self._speculative = 0
+        self._functions = {}
+        self._data_lines = 0
+        self._data_known = data is not None
+        self._outputs = []
+        self._output = False
+        self._error = None
+        self._folded = True
+        self._residual_loops = 0
+
+    def specialize(self, program: 'bnf_grammar.Prog') -> None:
+        """Specialize a parsed Core program."""
+        try:
+            program.specialize(self)
+        except _Stop:
+            pass
+
+    def _function(self, node: 'bnf_grammar.Exp | bnf_grammar.Cond'
+                  ) -> tuple[Callable, list['bnf_grammar.Id']]:
+        """Return a node translated to a Python function of its Ids."""
+        if node not in self._functions:
+            names = _Names(lambda identifier: 'v_' + identifier.get_name())
+            source = node.compile(names)
+            function = eval('lambda {0}: {1}'.format(
+                ', '.join(names.values()), source))
+            self._functions[node] = function, list(names)
+        return self._functions[node]
+
+    def _evaluate(self, node: 'bnf_grammar.Exp | bnf_grammar.Cond',
+                  line: int) -> int | bool | None:
+        """Return the value of a node, or None if it is dynamic.
+
+        Args:
+            node: The <exp> or <cond> node to evaluate.
+            line: The line whereat the statement that contains the
+                node appears in the Core program.
+        """
+        function, identifiers = self._function(node)
+        values = []
+        for identifier in identifiers:
+            value = self._state.get(identifier, _Unset(identifier))
+            if value is DYNAMIC:
+                return None
+            values += [value]
+        try:
+            value = function(*values)
+            if isinstance(value, _Unset):
+                value._fail()
+            return value
+        except _Uninitialized as error:
+            if self._speculative:
+                return None
+            self._fail('{0} = {0};'.format(error.identifier.get_name()),
+                       bnf_grammar.runtime_error, io.StringIO(),
+                       'uninitialized identifier',
+                       error.identifier.line[line],
+                       error.identifier.get_name())
+
+    def _residual(self, node: 'bnf_grammar.Exp') -> str:
+        """Return the Core text of an <exp> with static Ids replaced."""
+        def name(identifier: 'bnf_grammar.Id') -> str:
+            value = self._state.get(identifier, DYNAMIC)
+            if value is DYNAMIC:
+                return identifier.get_name()
+            return literal(value)
+        return node.compile(_Names(name))
+
+    def _references(self, node: 'bnf_grammar.Cond') -> str:
+        """Return the Core text of a <cond>, materializing its Ids."""
+        self._materialize(self._function(node)[1])
+        return bnf_grammar.render(node)
+
+    def _emit(self, statement: str) -> None:
+        """Append a residual statement at the current indentation."""
+        self._lines += [bnf_grammar.Prog.pretty_print_indent * self._depth
+                        + statement]
+
+    def _materialize(self, identifiers: 'list[bnf_grammar.Id]',
+                     state: dict | None = None) -> None:
+        """Emit assignments of the static values of some Ids.
+
+        Args:
+            identifiers: The Id instances whose static values are
+                assigned, if they have static values.
+            state: The state in which the Id instances stay static
+                after the assignments, or None to keep the current
+                state.
+        """
+        for identifier in identifiers:
+            value = self._state.get(identifier, DYNAMIC)
+            if value is not DYNAMIC and (state is None
+                                         or state.get(identifier) is DYNAMIC):
+                self._emit('{0} = {1};'.format(identifier.get_name(),
+                                               literal(value)))
+
+    def _merge(self, left: dict, right: dict) -> dict:
+        """Return the state after two paths, which is static where equal."""
+        merged = {}
+        for identifier in left.keys() | right.keys():
+            value = left.get(identifier, DYNAMIC)
+            other = right.get(identifier, DYNAMIC)
+            if value is DYNAMIC or other is DYNAMIC or value != other:
+                value = DYNAMIC
+            merged[identifier] = value
+        return merged
+
+    def _speculate(self, stmt_seq: 'bnf_grammar.StmtSeq',
+                   state: dict) -> tuple[list[str], dict]:
+        """Specialize a <stmt seq> that may not be executed.
+
+        Args:
+            stmt_seq: The StmtSeq instance to specialize.
+            state: The state before the StmtSeq instance.
+
+        Returns:
+            A tuple of the residual statements and the state after the
+            StmtSeq instance.
+        """
+        lines, self._lines = self._lines, []
+        self._state = dict(state)
+        self._speculative += 1
+        self._depth += 1
+        stmt_seq.specialize(self)
+        self._depth -= 1
+        self._speculative -= 1
+        body, self._lines = self._lines, lines
+        return body, self._state
+
+    def _fail(self, statement: str, error: Callable, *args: object) -> None:
+        """End specialization at a statement that always fails.
+
+        Emit a statement that fails the same way in the residual
+        program, and keep the message of the runtime error.
+
+        Args:
+            statement: The residual statement that fails.
+            error: The function that raises the runtime error.
+            args: The arguments of the function.
+
+        Raises:
+            _Stop: Always.
+        """
+        self._emit(statement)
+        try:
+            error(*args)
+        except SystemExit as error_exit:
+            self._error = str(error_exit.code)
+        raise _Stop
+
+    def assign(self, identifier: 'bnf_grammar.Id', expression: 'bnf_grammar.Exp',
+               line: int) -> None:
+        """Specialize an <assign> node.
+
+        Args:
+            identifier: The Id instance assigned.
+            expression: The Exp instance whose value is assigned.
+            line: The line whereat the assignment appears in the Core
+                program.
+        """
+        self._steps += 1
+        value = self._evaluate(expression, line)
+        if value is None:
+            self._emit('{0} = {1};'.format(identifier.get_name(),
+                                           self._residual(expression)))
+            self._folded = False
+            value = DYNAMIC
+        self._state[identifier] = value
+
+    def branch(self, condition: 'bnf_grammar.Cond',
+               then_stmt_seq: 'bnf_grammar.StmtSeq',
+               else_stmt_seq: 'bnf_grammar.StmtSeq | None',
+               line: int) -> None:
+        """Specialize an <if> node.
+
+        Args:
+            condition: The Cond instance of the <if> node.
+            then_stmt_seq: The StmtSeq instance executed if the
+                condition holds.
+            else_stmt_seq: The StmtSeq instance executed otherwise, if
+                any.
+            line: The line whereat the <if> node appears in the Core
+                program.
+        """
+        self._steps += 1
+        outcome = self._evaluate(condition, line)
+        if outcome is not None:
+            if outcome:
+                then_stmt_seq.specialize(self)
+            elif else_stmt_seq:
+                else_stmt_seq.specialize(self)
+            return
+        text = self._references(condition)
+        state = self._state
+        then_lines, then_state = self._speculate(then_stmt_seq, state)
+        else_lines, else_state = [], state
+        if else_stmt_seq:
+            else_lines, else_state = self._speculate(else_stmt_seq, state)
+        merged = self._merge(then_state, else_state)
+        for lines, branch_state in ((then_lines, then_state),
+                                    (else_lines, else_state)):
+            outer, self._lines, self._state = self._lines, lines, branch_state
+            self._depth += 1
+            self._materialize(list(branch_state), merged)
+            self._depth -= 1
+            self._lines = outer
+        self._state = merged
+        if not then_lines and not else_lines:
+            return
+        self._emit('if {0} then'.format(text))
+        self._lines += then_lines or [bnf_grammar.Prog.pretty_print_indent
+                                      * (self._depth + 1) + _noop()]
+        if else_lines:
+            self._emit('else')
+            self._lines += else_lines
+        self._emit('end;')
+        self._folded = False
+
+    def loop(self, loop: 'bnf_grammar.Loop') -> None:
+        """Specialize a <loop> node.
+
+        Unroll the loop while its condition is static, its iterations
+        fold away, and the step budget lasts. Should any of them end
+        before the loop does, emit the rest of the loop with a
+        generalized state, so that an iteration that leaves residual
+        statements is emitted once rather than once per iteration.
+
+        Args:
+            loop: The Loop instance to specialize.
+        """
+        condition, stmt_seq = loop.get_condition(), loop.get_stmt_seq()
+        while self._steps < self._budget:
+            self._steps += 1
+            outcome = self._evaluate(condition, loop.get_line())
+            if outcome is None:
+                break
+            if not outcome:
+                return
+            emitted, folded = len(self._lines), self._folded
+            self._folded = True
+            stmt_seq.specialize(self)
+            if len(self._lines) > emitted and not self._folded:
+                break
+            self._folded = folded
+        entry = header = self._state
+        while True:
+            body, state = self._speculate(stmt_seq, header)
+            generalized = self._merge(header, state)
+            if generalized == header:
+                break
+            header = generalized
+        self._state = entry
+        self._materialize(list(entry), header)
+        self._state = header
+        text = self._references(condition)
+        body, state = self._speculate(stmt_seq, header)
+        outer, self._lines, self._state = self._lines, body, state
+        self._depth += 1
+        self._materialize(list(state), header)
+        self._depth -= 1
+        self._lines, self._state = outer, header
+        self._emit('while {0} loop'.format(text))
+        self._lines += body or [bnf_grammar.Prog.pretty_print_indent
+                                * (self._depth + 1) + _noop()]
+        self._emit('end;')
+        self._folded = False
+        self._residual_loops += 1
+
+    def read(self, identifiers: 'list[bnf_grammar.Id]', line: int) -> None:
+        """Specialize an <in> node.
+
+        Read the values from the data file while its position is known
+        and the node is always executed. Otherwise, emit the node,
+        after which the position in the data file is unknown.
+
+        Args:
+            identifiers: The Id instances read.
+            line: The line whereat the <in> node appears in the Core
+                program.
+        """
+        self._steps += 1
+        if not self._data_known or self._speculative:
+            self._emit('read {0};'.format(', '.join(
+                identifier.get_name() for identifier in identifiers)))
+            self._state.update(dict.fromkeys(identifiers, DYNAMIC))
+            self._data_known = False
+            self._folded = False
+            return
+        for identifier in identifiers:
+            try:
+                self._state[identifier] = self._data.next_value()
+            except StopIteration:
+                self._fail('read {0};'.format(identifier.get_name()),
+                           self._data.fail)
+            self._data_lines += 1
+
+    def write(self, identifiers: 'list[bnf_grammar.Id]', line: int) -> None:
+        """Specialize an <out> node.
+
+        Args:
+            identifiers: The Id instances written.
+            line: The line whereat the <out> node appears in the Core
+                program.
+        """
+        self._steps += 1
+        if not self._speculative:
+            self._output = True
+        for index, identifier in enumerate(identifiers):
+            if identifier not in self._state and not self._speculative:
+                if index:
+                    self._materialize(identifiers[:index])
+                    self._emit('write {0};'.format(', '.join(
+                        written.get_name()
+                        for written in identifiers[:index])))
+                self._fail('{0} = {0};'.format(identifier.get_name()),
+                           bnf_grammar.runtime_error, io.StringIO(),
+                           'uninitialized identifier', identifier.line[line],
+                           identifier.get_name())
+            value = self._state.get(identifier, DYNAMIC)
+            if value is DYNAMIC:
+                self._folded = False
+            elif not self._speculative:
+                self._outputs += ['{0} = {1}'.format(
+                    identifier.get_name(), digits.to_decimal(value))]
+        self._materialize(identifiers)
+        self._emit('write {0};'.format(', '.join(
+            identifier.get_name() for identifier in identifiers)))
+
+    def get_outputs(self) -> list[str]:
+        """Return the lines written by static "write" statements."""
+        return self._outputs
+
+    def has_output(self) -> bool:
+        """Return whether the output of the program has its header."""
+        return self._output
+
+    def get_error(self) -> str | None:
+        """Return the runtime error the program always ends with."""
+        return self._error
+
+    def is_folded(self) -> bool:
+        """Return whether the program folds to its output."""
+        return self._folded
+
+    def get_residual(self) -> str:
+        """Return the residual Core program."""
+        lines = ['program']
+        if bnf_grammar.Id.get_declared():
+            lines += [bnf_grammar.Prog.pretty_print_indent + 'int {0};'
+                      .format(', '.join(identifier.get_name() for identifier
+                                        in bnf_grammar.Id.get_declared()))]
+        lines += ['begin']
+        lines += self._lines or [bnf_grammar.Prog.pretty_print_indent
+                                 + _noop()]
+        lines += ['end']
+        return '\n'.join(lines) + '\n'
+
+    def dump_stats(self, file: TextIO = sys.stderr) -> None:
+        """Print the counters of the specialization.
+
+        Args:
+            file: The text stream to print the counters to.
+        """
+        print('Specializer statistics (step budget: {0})'
+              .format(self._budget), file = file)
+        print('  {0} step(s), {1} residual loop(s), {2} residual '
+              'line(s)'.format(self._steps, self._residual_loops,
+                                    len(self._lines)), file = file)
+        if self._steps >= self._budget:
+            print('  step budget exhausted', file = file)
+        if self._data is not None and not self._data_known:
+            print('  the residual program reads the data file from line '
+                  '{0}'.format(self._data_lines + 1), file = file)